@@ -0,0 +1,165 @@
+"""
+Block-Floating CSD Coefficient Banks
+
+Each block of coefficients shares one exponent e and stores, per
+coefficient, a CSD mantissa of a fixed number of digits: the value is
+``m * 2**e``. The exponent is the smallest one at which the largest
+magnitude of the block still fits the digits, so small coefficients do not
+pay for leading zeros of their own and large ones keep their precision.
+
+The mantissas of a block are held lane-packed as in `rb_adder`, so encoding
+is one packed NAF conversion per block, and a dot product runs digit plane
+by digit plane: for digit i, the inputs under a ``+`` are added, those
+under a ``-`` subtracted, and the plane is weighted by 2**i.
+"""
+from itertools import compress
+from math import fsum, frexp, ldexp
+from typing import List, NamedTuple, Sequence
+
+from csdigit.csd import to_csd, to_decimal
+from csdigit.mask import lane_constants, mask_to_csd
+from csdigit.rb_adder import RbVector, pack_values, rb_values
+
+
+class CsdBlock(NamedTuple):
+    """Mantissas of `width` CSD digits sharing the exponent"""
+
+    exponent: int
+    width: int
+    digits: RbVector
+
+
+class BlockReport(NamedTuple):
+    """Storage (in bits, two per digit) and worst error of a block bank,
+    next to those of per-coefficient `to_csd` strings"""
+
+    bits: int
+    csd_bits: int
+    max_error: float
+    csd_max_error: float
+
+
+def _naf_max(width: int) -> int:
+    """Largest value whose NAF has `width` digits, ``+0+0...``"""
+    return ((1 << (width + 1)) - 1) // 3
+
+
+def _exponent(peak: float, width: int) -> int:
+    if peak == 0.0:
+        return 0
+    limit = _naf_max(width)
+    exponent = frexp(peak / limit)[1] - 1
+    while round(ldexp(peak, -exponent)) > limit:
+        exponent += 1
+    return exponent
+
+
+def encode_blocks(
+    coeffs: Sequence[float], block_size: int = 16, width: int = 8
+) -> List[CsdBlock]:
+    """Quantize coefficients to blocks sharing an exponent
+
+    Examples:
+        >>> blocks = encode_blocks([0.75, -0.01, 3.0, 0.002], 2, 4)
+        >>> [(b.exponent, block_mantissas(b)) for b in blocks]
+        [(-3, ['+0-0', '0000']), (-1, ['+0-0', '0000'])]
+    """
+    if block_size < 1 or width < 1:
+        raise ValueError("Block size and width must be positive")
+    nbytes = (width + 2 + 7) // 8
+    blocks = []
+    for start in range(0, len(coeffs), block_size):
+        chunk = coeffs[start : start + block_size]
+        exponent = _exponent(max(abs(c) for c in chunk), width)
+        mantissas = [round(ldexp(c, -exponent)) for c in chunk]
+        blocks.append(CsdBlock(exponent, width, pack_values(mantissas, nbytes)))
+    return blocks
+
+
+def decode_blocks(blocks: Sequence[CsdBlock]) -> List[float]:
+    """Values of all coefficients
+
+    Examples:
+        >>> decode_blocks(encode_blocks([0.75, -0.01, 3.0, 0.002], 2, 4))
+        [0.75, 0.0, 3.0, 0.0]
+    """
+    return [
+        ldexp(m, block.exponent) for block in blocks for m in rb_values(block.digits)
+    ]
+
+
+def block_mantissas(block: CsdBlock) -> List[str]:
+    """The fixed-width CSD mantissas of a block"""
+    digits = block.digits
+    nbytes = digits.nbytes
+    size = digits.count * nbytes
+    pos = digits.pos.to_bytes(size, "little")
+    neg = digits.neg.to_bytes(size, "little")
+    return [
+        mask_to_csd(
+            int.from_bytes(pos[i : i + nbytes], "little"),
+            int.from_bytes(neg[i : i + nbytes], "little"),
+            block.width,
+        )
+        for i in range(0, size, nbytes)
+    ]
+
+
+def block_dot(blocks: Sequence[CsdBlock], xs: Sequence) -> float:
+    """``sum(c * x)`` by shift-adds over the digit planes of the mantissas
+
+    Examples:
+        >>> block_dot(encode_blocks([0.75, -0.25, 3.0], 2, 4), [4, 8, 1])
+        4.0
+    """
+    partial = []
+    start = 0
+    for block in blocks:
+        digits = block.digits
+        chunk = xs[start : start + digits.count]
+        start += digits.count
+        ones, _ = lane_constants(digits.count, 8 * digits.nbytes)
+        size = digits.count * digits.nbytes
+        total = 0
+        for i in reversed(range(block.width)):
+            plus = ((digits.pos >> i) & ones).to_bytes(size, "little")
+            minus = ((digits.neg >> i) & ones).to_bytes(size, "little")
+            total = total * 2 + sum(compress(chunk, plus[:: digits.nbytes]))
+            total -= sum(compress(chunk, minus[:: digits.nbytes]))
+        partial.append(ldexp(total, block.exponent))
+    return fsum(partial)
+
+
+def storage_bits(blocks: Sequence[CsdBlock], exponent_bits: int = 8) -> int:
+    """Bits of a bank: an exponent per block and two bits per digit"""
+    return sum(exponent_bits + 2 * b.width * b.digits.count for b in blocks)
+
+
+def block_report(
+    coeffs: Sequence[float],
+    blocks: Sequence[CsdBlock],
+    places: int,
+    exponent_bits: int = 8,
+) -> BlockReport:
+    """Compare a bank with converting every coefficient by `to_csd`
+
+    Examples:
+        >>> coeffs = [0.5, 0.31, -0.12, 0.07, 0.004, -0.0021, 0.0013, 0.0007]
+        >>> report = block_report(coeffs, encode_blocks(coeffs, 4, 6), 10)
+        >>> report.bits, report.csd_bits
+        (112, 176)
+    """
+    values = decode_blocks(blocks)
+    csds = [to_csd(c, places) for c in coeffs]
+    return BlockReport(
+        storage_bits(blocks, exponent_bits),
+        sum(2 * len(csd.replace(".", "")) for csd in csds),
+        max(abs(v - c) for v, c in zip(values, coeffs)),
+        max(abs(to_decimal(csd) - c) for csd, c in zip(csds, coeffs)),
+    )
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
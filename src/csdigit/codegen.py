@@ -0,0 +1,255 @@
+"""
+C Code Generation for Multiplierless Constant Kernels
+
+The shift-add network found by `extract_common_subexpressions` is written out
+as portable C99. The arithmetic is done on the unsigned type, where shifts
+and wrap-around are well defined, and converted back to the signed type at
+the end, so the result matches ``c * x`` modulo the word size.
+"""
+import os
+import re
+import shutil
+import subprocess
+import tempfile
+from typing import Dict, List, Optional, Sequence
+
+from csdigit.cse import Pattern, Term, extract_common_subexpressions
+
+
+def _width(ctype: str) -> int:
+    match = re.fullmatch(r"u?int(8|16|32|64)_t", ctype)
+    if match is None:
+        raise ValueError("Not a fixed-width integer type: {}".format(ctype))
+    return int(match.group(1))
+
+
+def _shifted(sym: int, shift: int) -> str:
+    return "(t{} << {})".format(sym, shift) if shift else "t{}".format(sym)
+
+
+def _sum_expr(terms: Sequence[Term], utype: str) -> str:
+    if not terms:
+        return "({})0".format(utype)
+    expr = ""
+    for shift, sign, sym in terms:
+        term = _shifted(sym, shift)
+        if not expr:
+            expr = term if sign > 0 else "({})0 - {}".format(utype, term)
+        else:
+            expr += " {} {}".format("+" if sign > 0 else "-", term)
+    return expr
+
+
+def _body(
+    subexprs: Sequence[Pattern],
+    terms: Sequence[Sequence[Term]],
+    load: str,
+    store: str,
+    ctype: str,
+    utype: str,
+    indent: str,
+) -> List[str]:
+    lines = ["{}{} t0 = ({}){};".format(indent, utype, utype, load)]
+    for k, (hi, lo, dist, sign) in enumerate(subexprs, 1):
+        op = "+" if sign > 0 else "-"
+        lines.append(
+            "{}{} t{} = {} {} t{};".format(indent, utype, k, _shifted(hi, dist), op, lo)
+        )
+    for i, t in enumerate(terms):
+        lines.append(
+            "{}{} = ({})({});".format(
+                indent, store.format(i), ctype, _sum_expr(t, utype)
+            )
+        )
+    return lines
+
+
+def emit_c(
+    constants: Sequence[int],
+    name: str = "mcm",
+    ctype: str = "int32_t",
+    utype: str = "uint32_t",
+    array: bool = False,
+) -> str:
+    """C source multiplying by every constant with shared shift-adds
+
+    The scalar form is ``void name(ctype x, ctype y[K])``. With `array` set,
+    ``void name(const ctype *x, ctype *y, size_t n)`` runs the same network
+    over n inputs in a branch-free loop that compilers vectorize; the output
+    for constant k and input i is ``y[k * n + i]``.
+
+    Args:
+        constants (Sequence[int]): the integer constants
+        name (str): function name
+        ctype (str): signed C type of inputs and outputs
+        utype (str): unsigned C type of the same width
+        array (bool): emit the array loop instead of the scalar function
+
+    Returns:
+        str: the C source
+
+    Raises:
+        ValueError: if a type is not one of the ``stdint.h`` fixed-width
+            types, or a constant does not fit `ctype` (a CSD digit would be
+            shifted by the word size or more)
+
+    Examples:
+        >>> print(emit_c([5, -10]))
+        #include <stddef.h>
+        #include <stdint.h>
+        <BLANKLINE>
+        void mcm(int32_t x, int32_t y[2])
+        {
+            uint32_t t0 = (uint32_t)x;
+            uint32_t t1 = (t0 << 2) + t0;
+            y[0] = (int32_t)(t1);
+            y[1] = (int32_t)((uint32_t)0 - (t1 << 1));
+        }
+        <BLANKLINE>
+        >>> emit_c([1 << 31])
+        Traceback (most recent call last):
+        ...
+        ValueError: Constant 2147483648 does not fit int32_t
+    """
+    width = _width(ctype)
+    if _width(utype) != width:
+        raise ValueError("{} and {} differ in width".format(ctype, utype))
+    for c in constants:
+        if not -(1 << (width - 1)) <= c < 1 << (width - 1):
+            raise ValueError("Constant {} does not fit {}".format(c, ctype))
+    subexprs, terms = extract_common_subexpressions(constants)
+    lines = ["#include <stddef.h>", "#include <stdint.h>", ""]
+    if array:
+        lines += [
+            "void {}(const {} *restrict x, {} *restrict y, size_t n)".format(
+                name, ctype, ctype
+            ),
+            "{",
+            "    for (size_t i = 0; i < n; ++i) {",
+        ]
+        lines += _body(subexprs, terms, "x[i]", "y[{} * n + i]", ctype, utype, " " * 8)
+        lines += ["    }", "}", ""]
+    else:
+        lines += [
+            "void {}({} x, {} y[{}])".format(name, ctype, ctype, len(constants)),
+            "{",
+        ]
+        lines += _body(subexprs, terms, "x", "y[{}]", ctype, utype, " " * 4)
+        lines += ["}", ""]
+    return "\n".join(lines)
+
+
+_HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const {ctype} coeffs[{count}] = {{{coeffs}}};
+
+static void reference(const {ctype} *restrict x, {ctype} *restrict y, size_t n)
+{{
+    for (size_t k = 0; k < {count}; ++k)
+        for (size_t i = 0; i < n; ++i)
+            y[k * n + i] = ({ctype})(({utype})x[i] * ({utype})coeffs[k]);
+}}
+
+static double seconds(void (*f)(const {ctype} *, {ctype} *, size_t),
+                      const {ctype} *x, {ctype} *y, size_t n, int repeat)
+{{
+    clock_t start = clock();
+    for (int r = 0; r < repeat; ++r) f(x, y, n);
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}}
+
+int main(void)
+{{
+    size_t n = {n};
+    int repeat = {repeat};
+    {ctype} *x = malloc(n * sizeof *x);
+    {ctype} *y = malloc(n * {count} * sizeof *y);
+    {ctype} *z = malloc(n * {count} * sizeof *z);
+    unsigned seed = 12345u;
+    for (size_t i = 0; i < n; ++i) {{
+        seed = seed * 1103515245u + 12345u;
+        x[i] = ({ctype})(seed >> 8);
+    }}
+    {name}(x, y, n);
+    reference(x, z, n);
+    int ok = 1;
+    for (size_t i = 0; i < n * {count}; ++i) ok &= y[i] == z[i];
+    double t_kernel = seconds({name}, x, y, n, repeat);
+    double t_mult = seconds(reference, x, z, n, repeat);
+    printf("%d %.6e %.6e\n", ok, t_kernel, t_mult);
+    free(x); free(y); free(z);
+    return ok ? 0 : 1;
+}}
+"""
+
+
+def compile_and_bench(
+    constants: Sequence[int],
+    n: int = 1 << 16,
+    repeat: int = 100,
+    cc: Optional[str] = None,
+    cflags: Sequence[str] = ("-O2", "-std=c99"),
+    ctype: str = "int32_t",
+    utype: str = "uint32_t",
+) -> Dict[str, float]:
+    """Compile the array kernel with the system compiler and time it
+
+    The harness checks the kernel against a loop using hardware
+    multiplication, then times both over `n` inputs `repeat` times.
+
+    Args:
+        constants (Sequence[int]): the integer constants
+        n (int): number of inputs
+        repeat (int): number of timed runs
+        cc (str, optional): compiler, defaults to $CC or "cc"
+        cflags (Sequence[str]): compiler flags
+        ctype (str): signed C type of inputs and outputs
+        utype (str): unsigned C type of the same width
+
+    Returns:
+        Dict[str, float]: ``ok`` (1.0 if the outputs matched), and the
+            ``kernel_ns`` and ``multiply_ns`` per product
+
+    Raises:
+        RuntimeError: if no compiler is found or the build fails
+    """
+    cc = cc or os.environ.get("CC", "cc")
+    if shutil.which(cc) is None:
+        raise RuntimeError("C compiler not found: {}".format(cc))
+    source = emit_c(constants, "kernel", ctype, utype, array=True)
+    source += _HARNESS.format(
+        ctype=ctype,
+        utype=utype,
+        count=len(constants),
+        coeffs=", ".join(str(c) for c in constants),
+        n=n,
+        repeat=repeat,
+        name="kernel",
+    )
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "kernel.c")
+        exe = os.path.join(tmp, "kernel")
+        with open(src, "w") as fp:
+            fp.write(source)
+        build = subprocess.run(
+            [cc, *cflags, "-o", exe, src], capture_output=True, text=True
+        )
+        if build.returncode != 0:
+            raise RuntimeError(build.stderr)
+        run = subprocess.run([exe], capture_output=True, text=True)
+    ok, t_kernel, t_mult = run.stdout.split()
+    products = n * len(constants) * repeat
+    return {
+        "ok": float(ok),
+        "kernel_ns": float(t_kernel) * 1e9 / products,
+        "multiply_ns": float(t_mult) * 1e9 / products,
+    }
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
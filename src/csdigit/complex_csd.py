@@ -0,0 +1,172 @@
+"""
+Complex Coefficients
+
+A complex tap ``c = a + jb`` is quantized as a pair of CSD strings. Its
+product with a sample ``x = xr + j xi`` takes four real products,
+
+    yr = a * xr - b * xi,    yi = a * xi + b * xr,
+
+so the real and imaginary parts of all taps form a single set of constants
+that multiplies xr and, identically, xi: the common subexpressions are
+extracted once over the set and built twice. Gauss' restructuring needs
+three real products,
+
+    k1 = a * (xr + xi),    k2 = (a + b) * xi,    k3 = (b - a) * xr,
+    yr = k1 - k2,          yi = k1 + k3,
+
+that is three constant sets on three inputs, and one pre-adder shared by
+all taps. `plan_complex` costs both and keeps the cheaper, and
+`evaluate_complex` runs a plan bit-true on many samples at once, packed in
+the lanes of one integer per input.
+"""
+from math import ldexp
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from csdigit.csd import to_csd, to_decimal
+from csdigit.cse import McmBlock, mcm_block
+from csdigit.rb_adder import check_lanes, pack_lanes, unpack_lanes
+
+
+def to_csd_complex(values: Sequence[complex], places: int) -> List[Tuple[str, str]]:
+    """`to_csd` of the real and imaginary part of every value, converting
+    each distinct part once
+
+    Examples:
+        >>> to_csd_complex([0.75 - 0.25j, 0.25j], 2)
+        [('0.++', '0.0-'), ('0', '0.0+')]
+    """
+    known: Dict[float, str] = {}
+
+    def convert(part: float) -> str:
+        csd = known.get(part)
+        if csd is None:
+            csd = known[part] = to_csd(part, places)
+        return csd
+
+    return [(convert(v.real), convert(v.imag)) for v in map(complex, values)]
+
+
+def quantize_complex(values: Sequence[complex], places: int) -> List[Tuple[int, int]]:
+    """The CSD pairs of `to_csd_complex` as integers scaled by 2**places
+
+    Examples:
+        >>> quantize_complex([0.75 - 0.25j, 0.25j], 2)
+        [(3, -1), (0, 1)]
+    """
+    return [
+        (round(ldexp(to_decimal(re), places)), round(ldexp(to_decimal(im), places)))
+        for re, im in to_csd_complex(values, places)
+    ]
+
+
+class ComplexPlan(NamedTuple):
+    """Shift-add structure of a bank of complex constant multipliers
+
+    The direct plan has one block, built for xr and again for xi; the Gauss
+    plan has the blocks of a on ``xr + xi``, of ``a + b`` on xi and of
+    ``b - a`` on xr.
+    """
+
+    coeffs: List[Tuple[int, int]]
+    gauss: bool
+    blocks: List[McmBlock]
+    adders: int
+
+
+def _combiners(us: Sequence[int], vs: Sequence[int]) -> int:
+    """Adders combining the products by u and by v into an output part,
+    where neither product is by zero"""
+    return sum(u != 0 and v != 0 for u, v in zip(us, vs))
+
+
+def plan_complex(
+    coeffs: Sequence[Tuple[int, int]], gauss: Optional[bool] = None
+) -> ComplexPlan:
+    """Extract the subexpressions of integer complex constants
+
+    Args:
+        coeffs (Sequence[Tuple[int, int]]): (real, imaginary) integer pairs,
+            e.g. from `quantize_complex`
+        gauss (bool): force or forbid the Gauss restructuring; by default
+            the plan with fewer adders is returned
+
+    Examples:
+        >>> coeffs = quantize_complex([0.75 + 0.375j, 0.375 - 0.75j], 3)
+        >>> plan = plan_complex(coeffs, gauss=False)
+        >>> plan.blocks[0].constants, plan.adders
+        ([3, 6], 6)
+        >>> plan_complex(coeffs, gauss=True).adders
+        10
+    """
+    coeffs = list(coeffs)
+    re = [a for a, _ in coeffs]
+    im = [b for _, b in coeffs]
+    plans = []
+    if not gauss:
+        block = mcm_block(re + im)
+        adders = 2 * block.adders() + 2 * _combiners(re, im)
+        plans.append(ComplexPlan(coeffs, False, [block], adders))
+    if gauss is not False:
+        sums = [a + b for a, b in coeffs]
+        diffs = [b - a for a, b in coeffs]
+        blocks = [mcm_block(re), mcm_block(sums), mcm_block(diffs)]
+        adders = any(re) + sum(block.adders() for block in blocks)
+        adders += _combiners(re, sums) + _combiners(re, diffs)
+        plans.append(ComplexPlan(coeffs, True, blocks, adders))
+    return min(plans, key=lambda p: p.adders)
+
+
+def _times(products: Dict[int, int], c: int) -> int:
+    return products[c] if c >= 0 else -products[-c]
+
+
+def evaluate_complex(
+    plan: ComplexPlan, samples: Sequence[Tuple[int, int]], nbytes: int = 8
+) -> List[List[Tuple[int, int]]]:
+    """Products of every constant with every integer sample, by the
+    shift-adds of the plan
+
+    The samples travel in lanes of `nbytes` bytes, so every output must
+    stay below ``2**(8 * nbytes - 1)`` in magnitude; `OverflowError` is
+    raised when the largest sample part times the largest ``|a| + |b|``
+    does not.
+
+    Returns:
+        List[List[Tuple[int, int]]]: (real, imaginary) products, by
+            constant and then by sample
+
+    Examples:
+        >>> plan = plan_complex([(3, 1), (0, -2)])
+        >>> evaluate_complex(plan, [(1, 0), (2, -1)])
+        [[(3, 1), (7, -1)], [(0, -2), (-2, -4)]]
+    """
+    count = len(samples)
+    peak = max((max(abs(r), abs(i)) for r, i in samples), default=0)
+    gain = max((abs(a) + abs(b) for a, b in plan.coeffs), default=0)
+    check_lanes(peak * gain, nbytes)
+    xr = pack_lanes([r for r, _ in samples], nbytes)
+    xi = pack_lanes([i for _, i in samples], nbytes)
+    outputs = []
+    if plan.gauss:
+        p1, p2, p3 = (
+            block.products(x) for block, x in zip(plan.blocks, (xr + xi, xi, xr))
+        )
+        for a, b in plan.coeffs:
+            k1 = _times(p1, a)
+            outputs.append((k1 - _times(p2, a + b), k1 + _times(p3, b - a)))
+    else:
+        pr, pi = plan.blocks[0].products(xr), plan.blocks[0].products(xi)
+        for a, b in plan.coeffs:
+            outputs.append(
+                (_times(pr, a) - _times(pi, b), _times(pi, a) + _times(pr, b))
+            )
+    return [
+        list(zip(unpack_lanes(yr, count, nbytes), unpack_lanes(yi, count, nbytes)))
+        for yr, yi in outputs
+    ]
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -1,7 +1,8 @@
 """
 Canonical Signed Digit Conversion
 """
-from math import ceil, fabs, log
+from math import ceil, fabs, frexp, log
+from typing import List, Sequence, Tuple
 
 
 def to_csd(num: float, places: int) -> str:
@@ -216,6 +217,85 @@ def to_csdfixed(num: float, nnz: int) -> str:
     return csd
 
 
+def to_csdfixed_pareto(num: float, max_nnz: int) -> List[Tuple[str, float, float]]:
+    """Every `to_csdfixed` approximation of `num` up to `max_nnz` non-zeros
+
+    The greedy digit sequence of `to_csdfixed` does not depend on the
+    budget: a budget of k only cuts it after the k-th non-zero and pads the
+    integer places with zeros. One pass therefore yields the whole front.
+
+    Args:
+        num (float): decimal value to be converted to CSD format
+        max_nnz (int): largest number of non-zeros
+
+    Returns:
+        List[Tuple[str, float, float]]: for nnz = 1..max_nnz, the CSD string
+            (equal to ``to_csdfixed(num, nnz)``), its value and the error
+            ``num - value``
+
+    Examples:
+        >>> to_csdfixed_pareto(28.5, 3)
+        [('+00000', 32.0, -3.5), ('+00-00', 28.0, 0.5), ('+00-00.+', 28.5, 0.0)]
+    """
+    if num == 0.0:
+        return [("0", 0.0, 0.0)] * max_nnz
+
+    orig = num
+    absnum = fabs(num)
+    if absnum < 1.0:
+        rem = 0.0
+        csd = "0"
+    else:
+        rem = ceil(log(absnum * 1.5, 2))
+        csd = ""
+    p2n = pow(2.0, rem)
+    value = 0.0
+    front: List[Tuple[str, float, float]] = []
+    while len(front) < max_nnz and (p2n > 1.0 or fabs(num) > 1e-100):
+        if p2n == 1.0:
+            csd += "."
+        p2n /= 2.0
+        det = 1.5 * num
+        if det > p2n:
+            csd += "+"
+            num -= p2n
+            value += p2n
+        elif det < -p2n:
+            csd += "-"
+            num += p2n
+            value -= p2n
+        else:
+            csd += "0"
+            continue
+        pad = "0" * (frexp(p2n)[1] - 1 if p2n > 1.0 else 0)
+        front.append((csd + pad, value, orig - value))
+    if len(front) < max_nnz:
+        # exhausted early: all larger budgets give the same string
+        last = front[-1] if front else (csd, value, orig - value)
+        front += [last] * (max_nnz - len(front))
+    return front
+
+
+def to_csdfixed_pareto_batch(
+    nums: Sequence[float], max_nnz: int
+) -> List[List[Tuple[str, float, float]]]:
+    """Apply `to_csdfixed_pareto` to every value in `nums`
+
+    Args:
+        nums (Sequence[float]): decimal values to be converted
+        max_nnz (int): largest number of non-zeros
+
+    Returns:
+        List[List[Tuple[str, float, float]]]: one front per value
+
+    Examples:
+        >>> fronts = to_csdfixed_pareto_batch([28.5, -0.5], 2)
+        >>> [[csd for csd, _, _ in front] for front in fronts]
+        [['+00000', '+00-00'], ['0.-', '0.-']]
+    """
+    return [to_csdfixed_pareto(num, max_nnz) for num in nums]
+
+
 if __name__ == "__main__":
     import doctest
 
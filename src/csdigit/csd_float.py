@@ -0,0 +1,166 @@
+"""
+Floating CSD Representation
+
+A value is held as ``mantissa * 2**exponent`` with an odd integer mantissa,
+whose CSD digits therefore start and end with a non-zero. Leading and
+trailing zero runs are never stored, so conversion and arithmetic cost time
+proportional to the significant digits, not to the magnitude: 1e-30 takes
+the 53 bits of its float mantissa instead of 110 places.
+"""
+from fractions import Fraction
+from typing import Optional, Union
+
+from csdigit.mask import csd_to_mask, mask_to_csd, to_csd_mask
+
+
+class CsdFloat:
+    """Exact value ``m * 2**exponent`` with odd `m` (or zero)
+
+    Examples:
+        >>> a = CsdFloat.from_float(28.5)
+        >>> a.mantissa, a.exponent
+        ('+00-00+', -1)
+        >>> a.to_csd()
+        '+00-00.+'
+        >>> float(a * CsdFloat.from_float(-0.5))
+        -14.25
+    """
+
+    __slots__ = ("_m", "_e")
+
+    def __init__(self, m: int, exponent: int = 0):
+        if m == 0:
+            exponent = 0
+        else:
+            tz = (m & -m).bit_length() - 1
+            m >>= tz
+            exponent += tz
+        self._m = m
+        self._e = exponent
+
+    @classmethod
+    def from_float(cls, num: float) -> "CsdFloat":
+        """Exact conversion of a finite float
+
+        Examples:
+            >>> CsdFloat.from_float(1e-30).exponent
+            -147
+        """
+        m, d = num.as_integer_ratio()
+        return cls(m, 1 - d.bit_length())
+
+    @classmethod
+    def from_fraction(
+        cls, num: Union[int, Fraction], digits: Optional[int] = None
+    ) -> "CsdFloat":
+        """Convert a `Fraction`, rounding to `digits` significant bits if the
+        denominator is not a power of two
+
+        Examples:
+            >>> CsdFloat.from_fraction(Fraction(57, 2)).to_csd()
+            '+00-00.+'
+            >>> CsdFloat.from_fraction(Fraction(1, 3), digits=8).to_csd()
+            '0.+0-0-0-0-'
+        """
+        num = Fraction(num)
+        p, q = num.numerator, num.denominator
+        if q & (q - 1) == 0:
+            return cls(p, 1 - q.bit_length())
+        if digits is None:
+            raise ValueError("Inexact fraction needs a number of digits")
+        # floor(log2 |num|) is within one of the bit length difference
+        msb = abs(p).bit_length() - q.bit_length()
+        if abs(num) < Fraction(2) ** msb:
+            msb -= 1
+        shift = digits - 1 - msb
+        scaled = num * Fraction(2) ** shift
+        return cls(round(scaled), -shift)
+
+    @classmethod
+    def from_csd(cls, csd: str) -> "CsdFloat":
+        """Parse a string in the format of `to_csd`
+
+        Examples:
+            >>> CsdFloat.from_csd("0.0000+0-")
+            CsdFloat(3, -7)
+        """
+        integer, _, frac = csd.partition(".")
+        pos, neg = csd_to_mask(integer + frac)
+        return cls(pos - neg, -len(frac))
+
+    @property
+    def exponent(self) -> int:
+        return self._e
+
+    @property
+    def mantissa(self) -> str:
+        """CSD digits of the odd mantissa"""
+        return mask_to_csd(*to_csd_mask(self._m))
+
+    @property
+    def nnz(self) -> int:
+        pos, neg = to_csd_mask(self._m)
+        return bin(pos).count("1") + bin(neg).count("1")
+
+    def to_csd(self) -> str:
+        """Exact string in the format of `to_csd`, expanding the zero runs
+
+        Examples:
+            >>> CsdFloat(3, 2).to_csd()
+            '+0-00'
+            >>> CsdFloat(-1, -3).to_csd()
+            '0.00-'
+        """
+        digits = self.mantissa
+        if self._e >= 0:
+            return digits + "0" * self._e if self._m else "0"
+        places = -self._e
+        if len(digits) > places:
+            return digits[:-places] + "." + digits[-places:]
+        return "0." + digits.rjust(places, "0")
+
+    def to_fraction(self) -> Fraction:
+        if self._e >= 0:
+            return Fraction(self._m << self._e)
+        return Fraction(self._m, 1 << -self._e)
+
+    def __float__(self) -> float:
+        # the mantissa of an exact product may exceed the float range
+        return float(self.to_fraction())
+
+    def __neg__(self) -> "CsdFloat":
+        return CsdFloat(-self._m, self._e)
+
+    def __add__(self, other: "CsdFloat") -> "CsdFloat":
+        if not isinstance(other, CsdFloat):
+            return NotImplemented
+        e = min(self._e, other._e)
+        m = (self._m << (self._e - e)) + (other._m << (other._e - e))
+        return CsdFloat(m, e)
+
+    def __sub__(self, other: "CsdFloat") -> "CsdFloat":
+        if not isinstance(other, CsdFloat):
+            return NotImplemented
+        return self + (-other)
+
+    def __mul__(self, other: "CsdFloat") -> "CsdFloat":
+        if not isinstance(other, CsdFloat):
+            return NotImplemented
+        return CsdFloat(self._m * other._m, self._e + other._e)
+
+    def __eq__(self, other) -> bool:
+        if not isinstance(other, CsdFloat):
+            return NotImplemented
+        return self._m == other._m and self._e == other._e
+
+    def __hash__(self) -> int:
+        return hash((self._m, self._e))
+
+    def __repr__(self) -> str:
+        return "CsdFloat({}, {})".format(self._m, self._e)
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
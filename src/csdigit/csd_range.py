@@ -0,0 +1,131 @@
+"""
+CSD Forms of Consecutive Integers
+
+Adding one to a CSD (non-adjacent form) number only touches its lowest
+digits. With little-endian digits d[0], d[1], ... the increment at position
+i is:
+
+- d[i] = -1: clear it;
+- d[i] = +1: clear it and carry into i + 1;
+- d[i] = 0 and d[i+1] = 0: set d[i] = +1;
+- d[i] = 0 and d[i+1] = -1: make it (0, -1), i.e. -2 + 1 = -1;
+- d[i] = 0 and d[i+1] = +1: make it (0, -1) and carry into i + 2.
+
+A carry always lands on a zero digit whose lower neighbour is zero, so the
+result stays non-adjacent. As with a binary counter, the number of digits
+touched is O(1) amortized.
+"""
+from typing import Iterator, Tuple
+
+from csdigit.mask import to_csd_mask
+
+_CHARS = {-1: ord("-"), 0: ord("0"), 1: ord("+")}
+
+
+class _CsdCounter:
+    """Little-endian CSD digits, kept together with their masks and a
+    right-aligned character buffer"""
+
+    def __init__(self, start: int):
+        self.pos, self.neg = to_csd_mask(start)
+        size = max(self.pos.bit_length(), self.neg.bit_length())
+        self.cap = max(64, 2 * size)
+        self.digits = [0] * self.cap
+        self.buf = bytearray(b"0" * self.cap)
+        self.top = -1
+        for i in range(size):
+            digit = (self.pos >> i & 1) - (self.neg >> i & 1)
+            if digit:
+                self.digits[i] = digit
+                self.buf[self.cap - 1 - i] = _CHARS[digit]
+                self.top = i
+
+    def _grow(self):
+        self.digits += [0] * self.cap
+        self.buf[:0] = b"0" * self.cap
+        self.cap *= 2
+
+    def _set(self, i: int, digit: int):
+        old = self.digits[i]
+        if old == 1:
+            self.pos ^= 1 << i
+        elif old == -1:
+            self.neg ^= 1 << i
+        if digit == 1:
+            self.pos ^= 1 << i
+        elif digit == -1:
+            self.neg ^= 1 << i
+        self.digits[i] = digit
+        self.buf[self.cap - 1 - i] = _CHARS[digit]
+        if digit and i > self.top:
+            self.top = i
+
+    def increment(self):
+        i = 0
+        digits = self.digits
+        while True:
+            if i + 2 >= self.cap:
+                self._grow()
+                digits = self.digits
+            digit = digits[i]
+            if digit == -1:
+                self._set(i, 0)
+                break
+            if digit == 1:
+                self._set(i, 0)
+                i += 1
+                continue
+            upper = digits[i + 1]
+            if upper == 0:
+                self._set(i, 1)
+                break
+            self._set(i + 1, 0)
+            self._set(i, -1)
+            if upper == -1:
+                break
+            i += 2
+        while self.top >= 0 and digits[self.top] == 0:
+            self.top -= 1
+
+    def __str__(self) -> str:
+        if self.top < 0:
+            return "0"
+        return self.buf[self.cap - 1 - self.top :].decode()
+
+
+def csd_range(start: int, stop: int) -> Iterator[str]:
+    """CSD strings of range(start, stop), in the format of `to_csd_i`
+
+    Examples:
+        >>> list(csd_range(-2, 4))
+        ['-0', '-', '0', '+', '+0', '+0-']
+    """
+    if start >= stop:
+        return
+    counter = _CsdCounter(start)
+    yield str(counter)
+    for _ in range(stop - start - 1):
+        counter.increment()
+        yield str(counter)
+
+
+def csd_mask_range(start: int, stop: int) -> Iterator[Tuple[int, int]]:
+    """CSD masks ``(pos, neg)`` of range(start, stop), as in `to_csd_mask`
+
+    Examples:
+        >>> list(csd_mask_range(2, 4))
+        [(2, 0), (4, 1)]
+    """
+    if start >= stop:
+        return
+    counter = _CsdCounter(start)
+    yield counter.pos, counter.neg
+    for _ in range(stop - start - 1):
+        counter.increment()
+        yield counter.pos, counter.neg
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,280 @@
+"""
+Common Subexpression Elimination for Multiple Constant Multiplication
+
+Every constant starts as the list of its CSD terms ``(shift, sign, symbol)``,
+where symbol 0 is the input x. A two-term pattern ``(hi, lo, d, sign)``
+stands for the new symbol ``(hi << d) + sign * lo``. Following Hartley, the
+pattern that occurs most often across all constants is turned into a new
+symbol and its occurrences are replaced, until no pattern occurs twice.
+
+For large coefficient sets, `PatternHistogram` counts the two-term patterns
+on the input digits of all constants at once, with the constants packed in
+the lanes of a pair of masks: the pairs at distance d with signs
+(hi, lo) are the set bits of ``(hi_mask >> d) & lo_mask``.
+"""
+from collections import Counter
+from typing import Dict, List, NamedTuple, Sequence, Tuple
+
+from csdigit.mask import to_csd_mask
+from csdigit.rb_adder import pack_values
+
+Term = Tuple[int, int, int]  # (shift, sign, symbol)
+Pattern = Tuple[int, int, int, int]  # (hi symbol, lo symbol, distance, sign)
+
+
+def csd_terms(num: int) -> List[Term]:
+    """CSD terms of `num` on the input symbol, most significant first
+
+    Examples:
+        >>> csd_terms(28)
+        [(5, 1, 0), (2, -1, 0)]
+    """
+    pos, neg = to_csd_mask(num)
+    terms = []
+    while pos or neg:
+        top = max(pos.bit_length(), neg.bit_length()) - 1
+        if pos >> top & 1:
+            terms.append((top, 1, 0))
+            pos ^= 1 << top
+        else:
+            terms.append((top, -1, 0))
+            neg ^= 1 << top
+    return terms
+
+
+def _pattern(upper: Term, lower: Term) -> Tuple[Pattern, int]:
+    """Pattern of two terms (upper has the larger shift) and the sign the
+    new symbol takes in their place"""
+    (s_hi, g_hi, y_hi), (s_lo, g_lo, y_lo) = upper, lower
+    return (y_hi, y_lo, s_hi - s_lo, g_hi * g_lo), g_hi
+
+
+def _count_patterns(terms: Sequence[Term]) -> Counter:
+    counts: Counter = Counter()
+    for i, upper in enumerate(terms):
+        for lower in terms[i + 1 :]:
+            counts[_pattern(upper, lower)[0]] += 1
+    return counts
+
+
+def _replace(terms: List[Term], pattern: Pattern, symbol: int) -> List[Term]:
+    """Replace non-overlapping occurrences of `pattern`, upper terms first"""
+    used = [False] * len(terms)
+    added = []
+    for i, upper in enumerate(terms):
+        if used[i]:
+            continue
+        for j in range(i + 1, len(terms)):
+            if used[j]:
+                continue
+            pat, sign = _pattern(upper, terms[j])
+            if pat == pattern:
+                used[i] = used[j] = True
+                added.append((terms[j][0], sign, symbol))
+                break
+    kept = [t for t, u in zip(terms, used) if not u]
+    return sorted(kept + added, key=lambda t: -t[0])
+
+
+def extract_common_subexpressions(
+    constants: Sequence[int],
+) -> Tuple[List[Pattern], List[List[Term]]]:
+    """Greedy Hartley-style CSE over the CSD forms of `constants`
+
+    Args:
+        constants (Sequence[int]): the integer constants
+
+    Returns:
+        Tuple[List[Pattern], List[List[Term]]]: the subexpressions, where
+            entry k defines symbol k + 1, and the terms of each constant
+
+    Examples:
+        >>> subexprs, terms = extract_common_subexpressions([5, 10, 21])
+        >>> subexprs
+        [(0, 0, 2, 1)]
+        >>> terms
+        [[(0, 1, 1)], [(1, 1, 1)], [(2, 1, 1), (0, 1, 0)]]
+    """
+    terms = [csd_terms(c) for c in constants]
+    subexprs: List[Pattern] = []
+    while True:
+        counts: Counter = Counter()
+        for t in terms:
+            counts.update(_count_patterns(t))
+        if not counts:
+            break
+        pattern, freq = max(counts.items(), key=lambda kv: (kv[1], -kv[0][2]))
+        if freq < 2:
+            break
+        subexprs.append(pattern)
+        symbol = len(subexprs)
+        terms = [_replace(t, pattern, symbol) for t in terms]
+    return subexprs, terms
+
+
+def adder_count(subexprs: Sequence[Pattern], terms: Sequence[Sequence[Term]]) -> int:
+    """Number of adders/subtractors used by a CSE solution
+
+    Examples:
+        >>> adder_count(*extract_common_subexpressions([5, 10, 21]))
+        2
+    """
+    return len(subexprs) + sum(max(len(t) - 1, 0) for t in terms)
+
+
+def evaluate_cse(
+    subexprs: Sequence[Pattern], terms: Sequence[Sequence[Term]], x: int
+) -> List[int]:
+    """Multiply `x` by every constant using the CSE solution
+
+    Examples:
+        >>> evaluate_cse(*extract_common_subexpressions([5, 10, 21]), 3)
+        [15, 30, 63]
+    """
+    values: Dict[int, int] = {0: x}
+    for k, (hi, lo, dist, sign) in enumerate(subexprs, 1):
+        values[k] = (values[hi] << dist) + sign * values[lo]
+    return [sum(sign * (values[sym] << shift) for shift, sign, sym in t) for t in terms]
+
+
+class McmBlock(NamedTuple):
+    """A constant set, by distinct non-zero magnitude, multiplying one input"""
+
+    constants: List[int]
+    subexprs: List[Pattern]
+    terms: List[List[Term]]
+
+    def adders(self) -> int:
+        return adder_count(self.subexprs, self.terms)
+
+    def products(self, x: int) -> Dict[int, int]:
+        """`x` times every magnitude, and times zero"""
+        products = dict(zip(self.constants, evaluate_cse(self.subexprs, self.terms, x)))
+        products[0] = 0
+        return products
+
+
+def mcm_block(constants: Sequence[int]) -> McmBlock:
+    """Extract the subexpressions of the distinct magnitudes of `constants`,
+    signs and zeros being free
+
+    Examples:
+        >>> block = mcm_block([-21, 5, 0, 21])
+        >>> block.constants, block.adders()
+        ([5, 21], 2)
+        >>> block.products(3)
+        {5: 15, 21: 63, 0: 0}
+    """
+    mags = sorted({abs(c) for c in constants} - {0})
+    return McmBlock(mags, *extract_common_subexpressions(mags))
+
+
+def summation_adders(coeffs: Sequence[int]) -> int:
+    """Adders summing the products by the non-zero `coeffs`
+
+    Examples:
+        >>> summation_adders([3, 0, -1, 2])
+        2
+    """
+    return max(sum(1 for c in coeffs if c) - 1, 0)
+
+
+# int.bit_count is Python 3.10+
+_popcount = getattr(int, "bit_count", lambda x: bin(x).count("1"))
+
+SignedPair = Tuple[int, int, int]  # (distance, hi sign, lo sign)
+
+
+class PatternHistogram:
+    """Counts of every (distance, sign pair) among the CSD digits of many
+    constants, kept up to date as patterns are extracted
+
+    Each constant gets a lane at least twice as wide as its digits, so the
+    shifted masks never pair digits of neighbouring constants.
+
+    Examples:
+        >>> hist = PatternHistogram([5, 10, 21])
+        >>> hist.counts[2, 1, 1]
+        4
+        >>> hist.patterns().most_common(1)
+        [((0, 0, 2, 1), 4)]
+        >>> hist.extract((0, 0, 2, 1))
+        3
+        >>> hist.masks()
+        [(0, 0), (0, 0), (1, 0)]
+    """
+
+    def __init__(self, constants: Sequence[int]):
+        self.count = len(constants)
+        width = max([abs(c) for c in constants] + [1]).bit_length() + 1
+        self.distance = width - 1  # the largest one possible
+        self.nbytes = (2 * width + 2 + 7) // 8
+        packed = pack_values(constants, self.nbytes)
+        self.pos, self.neg = packed.pos, packed.neg
+        self.counts = self._pairs(self.pos, self.neg, self.pos, self.neg)
+
+    def _pairs(self, hi_pos: int, hi_neg: int, lo_pos: int, lo_neg: int) -> Counter:
+        counts: Counter = Counter()
+        for d in range(1, self.distance + 1):
+            up_pos, up_neg = hi_pos >> d, hi_neg >> d
+            for sign_hi, up in ((1, up_pos), (-1, up_neg)):
+                for sign_lo, lo in ((1, lo_pos), (-1, lo_neg)):
+                    n = _popcount(up & lo)
+                    if n:
+                        counts[d, sign_hi, sign_lo] = n
+        return counts
+
+    def patterns(self) -> Counter:
+        """The counts merged by the product of the signs, as the patterns of
+        `extract_common_subexpressions` on the input symbol"""
+        merged: Counter = Counter()
+        for (d, sign_hi, sign_lo), n in self.counts.items():
+            if n:
+                merged[0, 0, d, sign_hi * sign_lo] += n
+        return merged
+
+    def extract(self, pattern: Pattern) -> int:
+        """Remove the non-overlapping occurrences of a pattern on the input
+        digits, upper ones first as in `extract_common_subexpressions`, and
+        update the counts by the pairs lost. Returns the occurrences."""
+        hi_sym, lo_sym, d, sign = pattern
+        if hi_sym or lo_sym or not 0 < d <= self.distance:
+            return 0
+        pos, neg = self.pos, self.neg
+        if sign > 0:
+            found = ((pos >> d) & pos) | ((neg >> d) & neg)
+        else:
+            found = ((pos >> d) & neg) | ((neg >> d) & pos)
+        # in a chain of occurrences d apart, take every other from the top
+        chosen = 0
+        while found:
+            heads = found & ~(found >> d)
+            chosen |= heads
+            found &= ~(heads | (heads >> d))
+        used = chosen | (chosen << d)
+        gone_pos, gone_neg = pos & used, neg & used
+        self.pos, self.neg = pos & ~used, neg & ~used
+        self.counts.subtract(self._pairs(gone_pos, gone_neg, pos, neg))
+        self.counts.subtract(self._pairs(self.pos, self.neg, gone_pos, gone_neg))
+        self.counts = +self.counts
+        return _popcount(chosen)
+
+    def masks(self) -> List[Tuple[int, int]]:
+        """The remaining input digits of every constant, as masks"""
+        size = self.count * self.nbytes
+        pos = self.pos.to_bytes(size, "little")
+        neg = self.neg.to_bytes(size, "little")
+        n = self.nbytes
+        return [
+            (
+                int.from_bytes(pos[i : i + n], "little"),
+                int.from_bytes(neg[i : i + n], "little"),
+            )
+            for i in range(0, size, n)
+        ]
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
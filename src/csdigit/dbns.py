@@ -0,0 +1,183 @@
+"""
+Double-Base Number System Recoding
+
+A constant is written as a sum of signed terms ``sign * 2**a * 3**b``. CSD
+is the special case b = 0; the powers of three give the recoding more
+terms to choose from, so it often gets by with fewer of them. In hardware
+the multiples ``3**b * x`` come from a chain of b adders
+``y + (y << 1)``, which a whole coefficient set shares, and every further
+term costs one adder as in CSD.
+
+`to_dbns` is the greedy recoding: it repeatedly takes the term closest to
+what is left, which needs only the bit lengths of the quotients by the few
+powers of three. `to_dbns_search` is a branch-and-bound search over the
+terms on either side of what is left, bounded by the better of the greedy
+and the CSD recoding, and never returns more terms than either.
+"""
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from csdigit.cse import csd_terms
+
+DbnsTerm = Tuple[int, int, int]  # (a, b, sign): sign * 2**a * 3**b
+
+
+def _candidates(rem: int, max_b: int) -> List[Tuple[int, int, int]]:
+    """The terms ``2**a * 3**b`` just below and above `rem` > 0, for every
+    b, as (distance, a, b)"""
+    result = []
+    power3 = 1
+    for b in range(max_b + 1):
+        if power3 > 2 * rem:
+            break
+        if rem < power3:
+            result.append((power3 - rem, 0, b))
+        else:
+            a = (rem // power3).bit_length() - 1
+            low = power3 << a
+            result.append((rem - low, a, b))
+            if rem != low:
+                result.append(((low << 1) - rem, a + 1, b))
+        power3 *= 3
+    return result
+
+
+def dbns_value(terms: Sequence[DbnsTerm]) -> int:
+    """Value of a recoding
+
+    Examples:
+        >>> dbns_value([(3, 2, 1), (0, 0, -1)])
+        71
+    """
+    return sum(sign * (3**b << a) for a, b, sign in terms)
+
+
+def to_dbns(num: int, max_b: int = 3) -> List[DbnsTerm]:
+    """Greedy double-base recoding, largest term first
+
+    Args:
+        num (int): the constant
+        max_b (int): the largest power of three
+
+    Examples:
+        >>> to_dbns(71)
+        [(3, 2, 1), (0, 0, -1)]
+        >>> to_dbns(71, 0)
+        [(6, 0, 1), (3, 0, 1), (0, 0, -1)]
+    """
+    terms = []
+    rem = num
+    while rem:
+        sign = 1 if rem > 0 else -1
+        _, a, b = min(_candidates(abs(rem), max_b))
+        terms.append((a, b, sign))
+        rem -= sign * (3**b << a)
+    return terms
+
+
+def to_dbns_search(num: int, max_b: int = 3, max_nodes: int = 10000) -> List[DbnsTerm]:
+    """Double-base recoding with the fewest terms the search finds
+
+    Depth-first search over the candidate terms of every step, nearest
+    first, pruning branches that cannot beat the best recoding so far. The
+    search stops after visiting `max_nodes` nodes.
+
+    Examples:
+        >>> to_dbns(41)
+        [(2, 2, 1), (1, 1, 1), (0, 0, -1)]
+        >>> to_dbns_search(41)
+        [(5, 0, 1), (0, 2, 1)]
+    """
+    best = min(
+        to_dbns(num, max_b),
+        [(shift, 0, sign) for shift, sign, _ in csd_terms(num)],
+        key=len,
+    )
+    nodes = 0
+    path: List[DbnsTerm] = []
+
+    def search(rem: int):
+        nonlocal best, nodes
+        nodes += 1
+        if rem == 0:
+            best = list(path)
+            return
+        if len(path) + 1 >= len(best) or nodes > max_nodes:
+            return
+        sign = 1 if rem > 0 else -1
+        for dist, a, b in sorted(_candidates(abs(rem), max_b)):
+            # what is left after the last term must itself be a term
+            if dist and len(path) + 2 >= len(best):
+                continue
+            path.append((a, b, sign))
+            search(rem - sign * (3**b << a))
+            path.pop()
+            if len(path) + 1 >= len(best):
+                return
+
+    search(num)
+    return best
+
+
+class DbnsCost(NamedTuple):
+    """Terms and adders of the double-base and CSD recodings"""
+
+    terms: int
+    csd_terms: int
+    adders: int  # terms - 1 per constant and the shared tripler chain
+    csd_adders: int
+
+
+def dbns_cost(recodings: Sequence[Sequence[DbnsTerm]]) -> DbnsCost:
+    """Cost of the recodings of a coefficient set, next to its CSD
+
+    Examples:
+        >>> dbns_cost([to_dbns(71), to_dbns(27)])
+        DbnsCost(terms=3, csd_terms=6, adders=4, csd_adders=4)
+    """
+    csd_nnz = [len(csd_terms(dbns_value(terms))) for terms in recodings]
+    max_b = max((b for terms in recodings for _, b, _ in terms), default=0)
+    return DbnsCost(
+        sum(map(len, recodings)),
+        sum(csd_nnz),
+        sum(max(len(terms) - 1, 0) for terms in recodings) + max_b,
+        sum(max(n - 1, 0) for n in csd_nnz),
+    )
+
+
+def to_dbns_batch(
+    nums: Sequence[int],
+    max_b: int = 3,
+    search: bool = False,
+    cache: Optional[Dict[int, List[DbnsTerm]]] = None,
+) -> List[List[DbnsTerm]]:
+    """Recode a coefficient set, converting each magnitude once
+
+    Args:
+        nums (Sequence[int]): the constants
+        max_b (int): the largest power of three
+        search (bool): use `to_dbns_search` instead of `to_dbns`
+        cache (dict): recodings of positive magnitudes, reused and filled in
+            across calls
+
+    Examples:
+        >>> to_dbns_batch([71, -71, 0])
+        [[(3, 2, 1), (0, 0, -1)], [(3, 2, -1), (0, 0, 1)], []]
+    """
+    recode = to_dbns_search if search else to_dbns
+    known = {} if cache is None else cache
+    result = []
+    for num in nums:
+        mag = abs(num)
+        terms = known.get(mag)
+        if terms is None:
+            terms = known[mag] = recode(mag, max_b)
+        if num < 0:
+            terms = [(a, b, -sign) for a, b, sign in terms]
+        result.append(list(terms))
+    return result
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,334 @@
+"""
+Size-Based Backend Dispatch
+
+Several functions have two implementations with the same results: the
+original digit-by-digit string loops, cheap for short inputs, and the mask
+and hashing versions, whose cost grows more slowly with the size of the
+input. The functions below pick one per call by comparing the input size
+with a threshold.
+
+The thresholds default to those measured on a typical machine. `calibrate`
+measures both backends here instead, and can save the result as JSON to
+``$CSDIGIT_DISPATCH_CONFIG`` or ``~/.config/csdigit/dispatch.json``, for
+`load_config` to read back; neither happens unless called. `set_backend`
+forces a backend regardless of size, and `counters` tells which backend
+handled how many calls.
+
+Examples:
+    >>> set_backend("to_csd_i", "mask")
+    >>> to_csd_i(28)
+    '+00-00'
+    >>> counters()[("to_csd_i", "mask")] >= 1
+    True
+    >>> set_backend("to_csd_i", None)
+"""
+import json
+import os
+import random
+from collections import Counter
+from math import ceil, fabs, frexp, ldexp, log
+from time import perf_counter
+from typing import Callable, Dict, Optional, Tuple
+
+from csdigit import csd, lcsre
+from csdigit.mask import csd_to_mask, mask_to_csd, to_csd_mask
+
+_DIGITS = str.maketrans("", "", "+-0.")
+
+
+def _to_csd_mask(num: float, places: int) -> Optional[str]:
+    """`to_csd` by the non-adjacent-form bit trick, or None if the result
+    could differ from the reference loop
+
+    The loop compares ``1.5 * rem`` in floating point with each place
+    weight. Its remainders are exact, but the product is rounded, and it
+    can round onto the place weight when the remainder lies within a
+    rounding error of 2/3 of it. That needs a remainder of 51 or more
+    significant bits, so only the first few places can be affected; they
+    are replayed here, and any such comparison falls back to the loop.
+    """
+    if num == 0.0:
+        return "0"
+    eps = ldexp(1.0, -places) if places >= 0 else 0.0
+    if eps == 0.0:
+        return None  # the loop's last place weight underflows
+    absnum = fabs(num)
+    # the same (float) estimate of the integer digits as the loop
+    rem = ceil(log(absnum * 1.5, 2)) if absnum >= 1.0 else 0
+    if rem > 1023:
+        return None  # the loop overflows
+    m, d = absnum.as_integer_ratio()
+    lowbit = ldexp(m & -m, 1 - d.bit_length())
+    p2n, r = ldexp(1.0, rem), num
+    while p2n > eps and p2n / lowbit >= 2.0**51:
+        p2n /= 2.0
+        det = 1.5 * r
+        if fabs(det) == p2n:
+            return None  # rounded onto the place weight
+        if det > p2n:
+            r -= p2n
+        elif det < -p2n:
+            r += p2n
+    m <<= places
+    three_half, half = 3 * m // (2 * d), m // (2 * d)
+    diff = three_half ^ half
+    pos, neg = three_half & diff, half & diff
+    if num < 0:
+        pos, neg = neg, pos
+    if absnum < 1.0:
+        if (pos | neg) >> places:
+            return None  # `to_csd` has no integer digit here
+        return "0." + mask_to_csd(pos, neg, places) if places else "0"
+    if (pos | neg) >> (rem + places):
+        return None
+    digits = mask_to_csd(pos, neg, rem + places)
+    return digits[:rem] + "." + digits[rem:] if places else digits
+
+
+def _to_csd_i_mask(num: int) -> str:
+    return mask_to_csd(*to_csd_mask(num))
+
+
+def _to_decimal_mask(csd_str: str) -> Optional[float]:
+    """`to_decimal` by parsing masks; None for input the loop would round
+    (more than 53 significant digits) or reject"""
+    if csd_str.translate(_DIGITS) or csd_str.count(".") > 1:
+        return None
+    integer, dot, frac = csd_str.partition(".")
+    digits = integer + frac
+    if len(digits.lstrip("0")) > 53:
+        return None
+    pos, neg = csd_to_mask(digits) if digits else (0, 0)
+    num = float(pos - neg)
+    if dot:
+        num /= pow(2.0, len(frac))
+    return num
+
+
+def _lrs_hash(csd_str: str) -> str:
+    """`longest_repeated_substring` by binary search on the length; among
+    the repeats of that length, the one the table finds first is the one
+    whose first occurrence starts earliest"""
+    length = len(lcsre.longest_repeated_substring_bounded(csd_str))
+    if length == 0:
+        return ""
+    first: Dict[str, int] = {}
+    last: Dict[str, int] = {}
+    for i in range(len(csd_str) - length + 1):
+        key = csd_str[i : i + length]
+        first.setdefault(key, i)
+        last[key] = i
+    start = min(i for key, i in first.items() if last[key] - i >= length)
+    return csd_str[start : start + length]
+
+
+def _csd_size(num: float, places: int) -> int:
+    return places + max(frexp(num)[1], 0)
+
+
+# name: (size of the arguments, {backend: function}, small, large)
+_SPECS: Dict[str, Tuple[Callable, Dict[str, Callable], str, str]] = {
+    "to_csd": (_csd_size, {"loop": csd.to_csd, "mask": _to_csd_mask}, "loop", "mask"),
+    "to_csd_i": (
+        lambda num: num.bit_length(),
+        {"loop": csd.to_csd_i, "mask": _to_csd_i_mask},
+        "loop",
+        "mask",
+    ),
+    "to_decimal": (
+        len,
+        {"loop": csd.to_decimal, "mask": _to_decimal_mask},
+        "loop",
+        "mask",
+    ),
+    "longest_repeated_substring": (
+        len,
+        {"table": lcsre.longest_repeated_substring, "hash": _lrs_hash},
+        "table",
+        "hash",
+    ),
+}
+
+# the smallest input size at which the large-input backend wins
+DEFAULT_THRESHOLDS: Dict[str, Optional[int]] = {
+    "to_csd": 64,
+    "to_csd_i": 32,
+    "to_decimal": 32,
+    "longest_repeated_substring": 4,
+}
+
+_thresholds: Dict[str, Optional[int]] = dict(DEFAULT_THRESHOLDS)
+_overrides: Dict[str, str] = {}
+_counters: Counter = Counter()
+
+
+def config_path() -> str:
+    return os.environ.get(
+        "CSDIGIT_DISPATCH_CONFIG",
+        os.path.join(os.path.expanduser("~"), ".config", "csdigit", "dispatch.json"),
+    )
+
+
+def _sample(name: str, size: int, rng: random.Random) -> tuple:
+    if name == "to_csd":
+        return (rng.uniform(-100.0, 100.0), max(size - 7, 0))
+    if name == "to_csd_i":
+        return (rng.getrandbits(size) | 1 << (size - 1),)
+    digits = csd.to_csd_i(rng.getrandbits(size) | 1 << (size - 1))
+    if name == "to_decimal":
+        return (digits[: size // 2] + "." + digits[size // 2 :],)
+    return (digits,)
+
+
+def _best_time(func: Callable, args: tuple, number: int = 20) -> float:
+    best = float("inf")
+    for _ in range(3):
+        start = perf_counter()
+        for _ in range(number):
+            func(*args)
+        best = min(best, perf_counter() - start)
+    return best
+
+
+def calibrate(
+    path: Optional[str] = None, save: bool = False
+) -> Dict[str, Optional[int]]:
+    """Measure both backends at growing sizes and set the thresholds
+
+    The threshold of a function is the smallest measured size from which the
+    large-input backend stays faster, or None if it never wins.
+
+    Args:
+        path (str): where to save the thresholds (default: `config_path`)
+        save (bool): whether to save them
+
+    Returns:
+        Dict[str, Optional[int]]: the thresholds by function name
+    """
+    rng = random.Random(1)
+    result: Dict[str, Optional[int]] = {}
+    for name, (_, backends, small, large) in _SPECS.items():
+        sizes = [4, 8, 16, 32, 64] if name == "longest_repeated_substring" else []
+        sizes = sizes or [4, 8, 16, 32, 64, 128, 256, 512]
+        threshold = None
+        for size in sizes:
+            args = _sample(name, size, rng)
+            fast = _best_time(backends[large], args)
+            slow = _best_time(backends[small], args)
+            if fast < slow:
+                threshold = size if threshold is None else threshold
+            else:
+                threshold = None
+        result[name] = threshold
+    _thresholds.clear()
+    _thresholds.update(result)
+    if save:
+        path = path or config_path()
+        try:
+            os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+            with open(path, "w") as fp:
+                json.dump({"version": 1, "thresholds": result}, fp, indent=2)
+        except OSError:
+            pass  # the thresholds still hold for this process
+    return result
+
+
+def load_config(path: Optional[str] = None) -> bool:
+    """Read saved thresholds; returns False if there are none"""
+    try:
+        with open(path or config_path()) as fp:
+            saved = json.load(fp)["thresholds"]
+    except (OSError, ValueError, KeyError, TypeError):
+        return False
+    _thresholds.clear()
+    _thresholds.update({name: saved.get(name) for name in _SPECS})
+    return True
+
+
+def thresholds() -> Dict[str, Optional[int]]:
+    """Current thresholds"""
+    return dict(_thresholds)
+
+
+def set_backend(name: str, backend: Optional[str]):
+    """Force a backend for a function, or go back to size-based dispatch
+    with None"""
+    if name not in _SPECS:
+        raise KeyError("Unknown function: {}".format(name))
+    if backend is None:
+        _overrides.pop(name, None)
+    elif backend not in _SPECS[name][1]:
+        raise ValueError("Unknown backend for {}: {}".format(name, backend))
+    else:
+        _overrides[name] = backend
+
+
+def counters() -> Counter:
+    """Calls handled so far, keyed by (function, backend)"""
+    return Counter(_counters)
+
+
+def reset_counters():
+    _counters.clear()
+
+
+def _dispatch(name: str, *args):
+    size_of, backends, small, large = _SPECS[name]
+    backend = _overrides.get(name)
+    if backend is None:
+        threshold = _thresholds.get(name)
+        use_large = threshold is not None and size_of(*args) >= threshold
+        backend = large if use_large else small
+    result = backends[backend](*args)
+    if result is None:  # outside the range where the backends agree
+        backend = small
+        result = backends[backend](*args)
+    _counters[name, backend] += 1
+    return result
+
+
+def to_csd(num: float, places: int) -> str:
+    """`csd.to_csd` on the backend chosen for the output size
+
+    Examples:
+        >>> to_csd(28.5, 2)
+        '+00-00.+0'
+    """
+    return _dispatch("to_csd", num, places)
+
+
+def to_csd_i(num: int) -> str:
+    """`csd.to_csd_i` on the backend chosen for the bit length
+
+    Examples:
+        >>> to_csd_i(-28)
+        '-00+00'
+    """
+    return _dispatch("to_csd_i", num)
+
+
+def to_decimal(csd_str: str) -> float:
+    """`csd.to_decimal` on the backend chosen for the string length
+
+    Examples:
+        >>> to_decimal("+00-00.+")
+        28.5
+    """
+    return _dispatch("to_decimal", csd_str)
+
+
+def longest_repeated_substring(csd_str: str) -> str:
+    """`lcsre.longest_repeated_substring` on the backend chosen for the
+    string length
+
+    Examples:
+        >>> longest_repeated_substring("+-00+-00+-00+-0")
+        '+-00+-0'
+    """
+    return _dispatch("longest_repeated_substring", csd_str)
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,193 @@
+"""
+Division by Constants via Reciprocal CSD Multiplication
+
+For an unsigned dividend ``0 <= y <= ymax`` and a divisor d, take
+``m = ceil(2**s / d)`` and ``e = m * d - 2**s`` (so ``0 <= e < d``). Writing
+``y = q * d + r``,
+
+    y * m / 2**s = q + r / d + y * e / (d * 2**s),
+
+so ``(y * m) >> s == y // d`` whenever ``e * ymax < 2**s``. Every shift that
+satisfies this bound gives a correct multiplier; the one whose CSD form has
+the fewest non-zeros gives the cheapest shift-add sequence. Rounded
+division adds ``d // 2`` to the dividend first.
+"""
+from typing import List, NamedTuple, Tuple
+
+from csdigit.csd import to_csd_i
+
+
+class DivisionPlan(NamedTuple):
+    divisor: int
+    nbits: int
+    offset: int  # added to the dividend before multiplying
+    multiplier: int
+    shift: int
+    csd: str  # CSD form of the multiplier
+    ops: List[Tuple[str, int]]  # shift-add sequence, see `evaluate_plan`
+    csd_adders: int
+    binary_adders: int
+
+
+def _shift_add_ops(csd: str) -> List[Tuple[str, int]]:
+    ops = []
+    top = len(csd) - 1
+    for pos, digit in enumerate(csd):
+        if digit == "0":
+            continue
+        if not ops:
+            ops.append(("set" if digit == "+" else "neg", top - pos))
+        else:
+            ops.append(("add" if digit == "+" else "sub", top - pos))
+    return ops
+
+
+def division_plan(divisor: int, nbits: int, rounding: str = "floor") -> DivisionPlan:
+    """Multiplier, shift and shift-add sequence for dividing by a constant
+
+    Args:
+        divisor (int): the constant divisor, positive
+        nbits (int): width of the unsigned dividend
+        rounding (str): "floor" for ``x // d``, "round" for the nearest
+            integer with ties rounded up
+
+    Returns:
+        DivisionPlan: the plan, with adder counts for the CSD and the plain
+            binary form of the multiplier
+
+    Examples:
+        >>> plan = division_plan(10, 16)
+        >>> plan.multiplier, plan.shift, plan.csd
+        (52429, 19, '+0-0+0-0+0-0+0-0+')
+        >>> evaluate_plan(plan, 12345)
+        1234
+        >>> division_plan(3, 8, "round").offset
+        1
+    """
+    if divisor <= 0:
+        raise ValueError("Divisor must be positive")
+    if rounding == "floor":
+        offset = 0
+    elif rounding == "round":
+        offset = divisor // 2
+    else:
+        raise ValueError("Rounding must be 'floor' or 'round'")
+
+    ymax = (1 << nbits) - 1 + offset
+    best = None
+    for shift in range(ymax.bit_length() + divisor.bit_length() + 1):
+        multiplier = -(-(1 << shift) // divisor)
+        error = multiplier * divisor - (1 << shift)
+        if error * ymax >= 1 << shift:
+            continue
+        csd = to_csd_i(multiplier)
+        cost = len(csd) - csd.count("0")
+        if best is None or cost < best[0]:
+            best = (cost, multiplier, shift, csd)
+
+    cost, multiplier, shift, csd = best
+    extra = 1 if offset else 0
+    return DivisionPlan(
+        divisor,
+        nbits,
+        offset,
+        multiplier,
+        shift,
+        csd,
+        _shift_add_ops(csd),
+        cost - 1 + extra,
+        bin(multiplier).count("1") - 1 + extra,
+    )
+
+
+def evaluate_plan(plan: DivisionPlan, x: int) -> int:
+    """Run the shift-add sequence of `plan` on the dividend `x`
+
+    The operations are ``set``/``neg`` (start the accumulator with
+    ``+-(y << k)``) and ``add``/``sub`` (accumulate ``+-(y << k)``), where
+    ``y = x + plan.offset``; the result is the accumulator shifted right by
+    ``plan.shift``.
+    """
+    y = x + plan.offset
+    acc = 0
+    for op, k in plan.ops:
+        if op == "set":
+            acc = y << k
+        elif op == "neg":
+            acc = -(y << k)
+        elif op == "add":
+            acc += y << k
+        else:
+            acc -= y << k
+    return acc >> plan.shift
+
+
+def format_plan(plan: DivisionPlan) -> str:
+    """Pseudo-code listing of the shift-add sequence
+
+    Examples:
+        >>> print(format_plan(division_plan(3, 8)))
+        y = x
+        acc = y << 8
+        acc = acc - (y << 6)
+        acc = acc - (y << 4)
+        acc = acc - (y << 2)
+        acc = acc - y
+        q = acc >> 9
+    """
+    lines = ["y = x + {}".format(plan.offset) if plan.offset else "y = x"]
+    for op, k in plan.ops:
+        term = "(y << {})".format(k) if k else "y"
+        if op == "set":
+            lines.append("acc = " + (term[1:-1] if k else term))
+        elif op == "neg":
+            lines.append("acc = -" + term)
+        else:
+            sign = "+" if op == "add" else "-"
+            lines.append("acc = acc {} {}".format(sign, term))
+    lines.append("q = acc >> {}".format(plan.shift))
+    return "\n".join(lines)
+
+
+def verify_plan(plan: DivisionPlan, exhaustive_limit: int = 1 << 20) -> str:
+    """Check a plan, exhaustively if the input range is small enough
+
+    Args:
+        plan (DivisionPlan): the plan to check
+        exhaustive_limit (int): largest number of dividends to try one by one
+
+    Returns:
+        str: "exhaustive" or "bound", the method that proved the plan
+
+    Raises:
+        ValueError: if the plan gives a wrong quotient
+
+    Examples:
+        >>> verify_plan(division_plan(7, 12))
+        'exhaustive'
+        >>> verify_plan(division_plan(7, 32))
+        'bound'
+    """
+    d = plan.divisor
+    count = 1 << plan.nbits
+    if count <= exhaustive_limit:
+        for x in range(count):
+            if evaluate_plan(plan, x) != (x + plan.offset) // d:
+                raise ValueError("Wrong quotient for {}".format(x))
+        return "exhaustive"
+
+    ymax = count - 1 + plan.offset
+    error = plan.multiplier * d - (1 << plan.shift)
+    if not 0 <= error * ymax < 1 << plan.shift:
+        raise ValueError("Error bound does not hold")
+    if plan.multiplier != sum(
+        (1 if op in ("set", "add") else -1) << k for op, k in plan.ops
+    ):
+        raise ValueError("Shift-add sequence does not match the multiplier")
+    return "bound"
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,179 @@
+"""
+IIR Second-Order Sections
+
+A section ``(b0, b1, b2, a0, a1, a2)``, laid out like the rows of SciPy's
+``sos`` arrays, has the poles of ``z**2 + a1 * z + a2``. Quantizing a1 and
+a2 to CSD moves the poles, and may move them onto or outside the unit
+circle: the section is stable exactly when (a1, a2) lies inside the
+triangle ``|a2| < 1``, ``|a1| < 1 + a2``.
+
+`quantize_sos_batch` converts the coefficients of many sections, each
+distinct value once, and screens every result: the triangle test first,
+then the pole radius and the displacement of the poles from those of the
+unquantized section, both from the closed-form roots. Sections that fail
+the screen are retried with nearby CSD values of a1 and a2, a few steps
+of one place weight up or down, keeping the candidate whose poles move
+least.
+"""
+from cmath import sqrt
+from itertools import product
+from math import inf, ldexp
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from csdigit.csd import to_csd, to_csdfixed, to_decimal
+
+Section = Sequence[float]  # b0, b1, b2, a0, a1, a2
+
+
+class SosResult(NamedTuple):
+    """A quantized section and its screen
+
+    `csds` and `values` hold b0, b1, b2, a1 and a2, with a0 = 1.
+    """
+
+    csds: Tuple[str, ...]
+    values: Tuple[float, ...]
+    radius: float  # largest pole magnitude
+    shift: float  # largest pole displacement
+    adjusted: bool  # a1 or a2 moved off the nearest CSD value
+
+
+def poles(a1: float, a2: float) -> Tuple[complex, complex]:
+    """Roots of ``z**2 + a1 * z + a2``
+
+    Examples:
+        >>> poles(-1.0, 0.5)
+        ((0.5+0.5j), (0.5-0.5j))
+    """
+    root = sqrt(a1 * a1 - 4.0 * a2)
+    return (-a1 + root) / 2.0, (-a1 - root) / 2.0
+
+
+def in_triangle(a1: float, a2: float) -> bool:
+    """Whether a section with this denominator is stable
+
+    Examples:
+        >>> in_triangle(-1.0, 0.5), in_triangle(-1.6, 0.5)
+        (True, False)
+    """
+    return abs(a2) < 1.0 and abs(a1) < 1.0 + a2
+
+
+def pole_shift(old: Tuple[complex, complex], new: Tuple[complex, complex]) -> float:
+    """Largest distance between two pairs of poles, matched to minimize it"""
+    (p, q), (r, s) = old, new
+    return min(max(abs(p - r), abs(q - s)), max(abs(p - s), abs(q - r)))
+
+
+def _nnz(csd: str) -> int:
+    return csd.count("+") + csd.count("-")
+
+
+def _places(csd: str) -> int:
+    return len(csd.partition(".")[2])
+
+
+def quantize_sos_batch(
+    sections: Sequence[Section],
+    places: Optional[int] = None,
+    nnz: Optional[int] = None,
+    max_shift: float = inf,
+    margin: float = 0.0,
+    reach: int = 2,
+) -> List[SosResult]:
+    """Quantize second-order sections to CSD, screened for stability
+
+    A section passes the screen when its poles lie within radius
+    ``1 - margin`` and moved by at most `max_shift`. Otherwise the values
+    of a1 and a2 up to `reach` steps away, in steps of any of their place
+    weights, are tried in all pairs, and the passing candidate with the
+    smallest pole displacement, then the fewest non-zeros, is kept. With
+    `nnz`, the candidate values are converted by `to_csdfixed` again,
+    keeping the number of non-zeros. A section with no passing candidate
+    keeps its nearest CSD values, and its radius tells that it failed.
+
+    Args:
+        sections (Sequence[Section]): (b0, b1, b2, a0, a1, a2) rows
+        places (int, optional): number of fractional places, as in `to_csd`
+        nnz (int, optional): number of non-zeros, as in `to_csdfixed`
+        max_shift (float): largest pole displacement that passes
+        margin (float): distance from the unit circle that passes
+        reach (int): steps to search around a1 and a2 at each place
+
+    Examples:
+        >>> in_triangle(to_decimal(to_csd(-1.97, 3)), to_decimal(to_csd(0.975, 3)))
+        False
+        >>> [r] = quantize_sos_batch([(1, 0, 0, 1, -1.97, 0.975)], places=3)
+        >>> r.csds[3:], r.values[3:], r.adjusted, round(r.radius, 4)
+        (('-0.0+0', '0.+++'), (-1.75, 0.875), True, 0.9354)
+    """
+    if (places is None) == (nnz is None):
+        raise ValueError("Give exactly one of places or nnz")
+    known: Dict[float, str] = {}
+
+    def quantize(num: float) -> str:
+        csd = known.get(num)
+        if csd is None:
+            if places is None:
+                csd = known[num] = to_csdfixed(num, nnz)
+            else:
+                csd = known[num] = to_csd(num, places)
+        return csd
+
+    def neighbors(csd: str) -> List[str]:
+        """The CSD values up to `reach` steps away, in steps of every place
+        weight from the last place up"""
+        value = to_decimal(csd)
+        digits = _places(csd)
+        found = {csd}
+        for place in range(digits, -1, -1):
+            for k in range(1, reach + 1):
+                for offset in (ldexp(k, -place), ldexp(-k, -place)):
+                    if nnz is None:
+                        found.add(to_csd(value + offset, digits))
+                    else:
+                        found.add(quantize(value + offset))
+        return sorted(found)
+
+    limit = 1.0 - margin
+    results = []
+    for b0, b1, b2, a0, a1, a2 in sections:
+        coeffs = [c / a0 for c in (b0, b1, b2, a1, a2)]
+        csds = [quantize(c) for c in coeffs]
+        target = poles(coeffs[3], coeffs[4])
+
+        def screen(c1: str, c2: str) -> Tuple[float, float]:
+            q1, q2 = to_decimal(c1), to_decimal(c2)
+            if not in_triangle(q1, q2):
+                return inf, inf
+            new = poles(q1, q2)
+            return max(abs(new[0]), abs(new[1])), pole_shift(target, new)
+
+        radius, shift = screen(csds[3], csds[4])
+        adjusted = False
+        if not (radius < limit and shift <= max_shift):
+            best = None
+            for c1, c2 in product(neighbors(csds[3]), neighbors(csds[4])):
+                r, s = screen(c1, c2)
+                if r < limit and s <= max_shift:
+                    key = (s, _nnz(c1) + _nnz(c2))
+                    if best is None or key < best[0]:
+                        best = key, c1, c2, r
+            if best is not None:
+                (shift, _), csds[3], csds[4], radius = best
+                adjusted = True
+        if radius == inf:  # outside the triangle: the poles, for the record
+            new = poles(to_decimal(csds[3]), to_decimal(csds[4]))
+            radius, shift = max(abs(new[0]), abs(new[1])), pole_shift(target, new)
+        results.append(
+            SosResult(
+                tuple(csds), tuple(map(to_decimal, csds)), radius, shift, adjusted
+            )
+        )
+    return results
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,341 @@
+"""
+2D Kernel Quantization
+
+An image kernel K of h rows and w columns filters the lines of an image as
+they stream in. In the direct plan, each incoming line
+
+- feeds one constant set, with its common subexpressions, holding the
+  distinct tap magnitudes of all rows,
+- feeds a row filter per distinct row up to sign (rows equal up to sign
+  reuse its output, negated or not),
+
+and the row filter outputs of the last h lines are summed.
+
+A separable plan writes K as a sum of outer products ``u_k v_k^T``, found
+by power iteration with deflation. Each v_k is a row filter on the incoming
+line, again all from one constant set; each u_k is a column filter on the
+output of v_k, with a constant set of its own. At rank one, that is h + w
+taps in place of h * w.
+
+The taps, or the factors, are quantized by `to_csdfixed` under one budget
+of non-zero digits, handed out a digit at a time to the tap whose error
+drops the most. `convolve2d` runs a plan bit-true on an integer image: the
+pixels of a line are packed in the lanes of one integer, so a horizontal
+shift of the whole line is a shift by whole lanes.
+"""
+import heapq
+from math import fsum, ldexp, sqrt
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from csdigit.csd import to_csdfixed, to_decimal
+from csdigit.cse import mcm_block, summation_adders
+from csdigit.rb_adder import check_lanes, pack_lanes, unpack_lanes
+
+Kernel = Sequence[Sequence[float]]
+
+
+def low_rank(
+    kernel: Kernel, rank: int, iterations: int = 200, tol: float = 1e-12
+) -> List[Tuple[float, List[float], List[float]]]:
+    """Up to `rank` singular triplets (sigma, u, v), largest first
+
+    Examples:
+        >>> [(s, u, v)] = low_rank([[1, 2], [2, 4]], 1)
+        >>> round(s, 9), [round(x, 6) for x in u + v]
+        (5.0, [0.447214, 0.894427, 0.447214, 0.894427])
+    """
+    rest = [[float(x) for x in row] for row in kernel]
+    triplets = []
+    for _ in range(rank):
+        # start from the row of the largest norm
+        v = max(rest, key=lambda row: fsum(x * x for x in row))
+        for _ in range(iterations):
+            u = [fsum(x * y for x, y in zip(row, v)) for row in rest]
+            w = [fsum(ui * row[j] for ui, row in zip(u, rest)) for j in range(len(v))]
+            norm = sqrt(fsum(x * x for x in w))
+            if norm == 0.0:
+                return triplets
+            w = [x / norm for x in w]
+            step = max(abs(x - y) for x, y in zip(v, w))
+            v = w
+            if step < tol:
+                break
+        u = [fsum(x * y for x, y in zip(row, v)) for row in rest]
+        sigma = sqrt(fsum(x * x for x in u))
+        if sigma == 0.0:
+            break
+        u = [x / sigma for x in u]
+        triplets.append((sigma, u, v))
+        rest = [[x - sigma * a * b for x, b in zip(row, v)] for row, a in zip(rest, u)]
+    return triplets
+
+
+def allocate_nnz(
+    values: Sequence[float],
+    budget: int,
+    weights: Optional[Sequence[float]] = None,
+    tol: float = 0.0,
+) -> List[str]:
+    """`to_csdfixed` of every value, sharing `budget` non-zero digits
+
+    Each further digit goes to the value whose weighted error drops the
+    most, until the budget is spent or no digit lowers an error by more
+    than `tol`.
+
+    Examples:
+        >>> allocate_nnz([0.75, 0.3, 0.0625], 3)
+        ['0.++', '0.0+', '0']
+    """
+    weights = weights or [1.0] * len(values)
+    nnz = [0] * len(values)
+    csds = ["0"] * len(values)
+
+    def gain(i: int) -> Tuple[float, str]:
+        csd = to_csdfixed(values[i], nnz[i] + 1)
+        old = abs(values[i] - to_decimal(csds[i]))
+        return weights[i] * (old - abs(values[i] - to_decimal(csd))), csd
+
+    heap = []
+    for i in range(len(values)):
+        g, csd = gain(i)
+        heap.append((-g, i, csd))
+    heapq.heapify(heap)
+    while budget > 0 and heap:
+        g, i, csd = heapq.heappop(heap)
+        if -g <= tol:
+            break
+        csds[i] = csd
+        nnz[i] += 1
+        budget -= 1
+        g, csd = gain(i)
+        heapq.heappush(heap, (-g, i, csd))
+    return csds
+
+
+def _trailing_zeros(ints: Sequence[int]) -> int:
+    bits = 0
+    for x in ints:
+        bits |= x
+    return (bits & -bits).bit_length() - 1 if bits else 0
+
+
+def _integers(csds: Sequence[str]) -> Tuple[List[int], int]:
+    """CSD strings as integers over the smallest common power of two, and
+    its exponent"""
+    places = max((len(csd.partition(".")[2]) for csd in csds), default=0)
+    ints = [round(ldexp(to_decimal(csd), places)) for csd in csds]
+    zeros = _trailing_zeros(ints)
+    return [x >> zeros for x in ints], places - zeros
+
+
+class KernelPlan(NamedTuple):
+    """A quantized kernel: ``integer_kernel(plan) / 2**plan.shift``
+
+    The direct plan (rank 0) holds the integer taps in `taps`; a separable
+    plan holds integer (column, row) factor pairs in `factors`.
+    """
+
+    rank: int
+    shift: int
+    taps: List[List[int]]
+    factors: List[Tuple[List[int], List[int]]]
+    nnz: int
+    adders: int
+    max_error: float
+
+
+def _row_key(row: Sequence[int]) -> Tuple[Tuple[int, ...], int, int]:
+    """A row as ``sign * key << shift``, with the first non-zero tap of the
+    key positive and one of its taps odd"""
+    lead = next((x for x in row if x), 0)
+    if not lead:
+        return tuple(row), 1, 0
+    shift = _trailing_zeros(row)
+    sign = 1 if lead > 0 else -1
+    return tuple(sign * x >> shift for x in row), sign, shift
+
+
+def integer_kernel(plan: KernelPlan) -> List[List[int]]:
+    """The integer kernel a plan applies
+
+    Examples:
+        >>> integer_kernel(plan_kernel([[1, 2], [2, 4]], 8, rank=1))
+        [[1, 2], [2, 4]]
+    """
+    if not plan.rank:
+        return [list(row) for row in plan.taps]
+    height, width = len(plan.factors[0][0]), len(plan.factors[0][1])
+    return [
+        [sum(u[i] * v[j] for u, v in plan.factors) for j in range(width)]
+        for i in range(height)
+    ]
+
+
+def _max_error(kernel: Kernel, plan: KernelPlan) -> float:
+    approx = integer_kernel(plan)
+    return max(
+        abs(x - ldexp(y, -plan.shift))
+        for row, arow in zip(kernel, approx)
+        for x, y in zip(row, arow)
+    )
+
+
+def plan_kernel(kernel: Kernel, budget: int, rank: int = 0) -> KernelPlan:
+    """Quantize a kernel directly (rank 0) or as a sum of `rank` outer
+    products, with `budget` non-zero digits in all
+
+    Outer products with a factor quantized to zero are dropped, so the rank
+    of the plan may be lower; without any left, the plan is the direct one
+    of the zero kernel.
+
+    Examples:
+        >>> kernel = [[1, 2, 1], [2, 4, 2], [1, 2, 1]]
+        >>> direct, separable = plan_kernel(kernel, 9), plan_kernel(kernel, 6, 1)
+        >>> separable.factors
+        [([1, 2, 1], [1, 2, 1])]
+        >>> direct.adders, separable.adders, separable.max_error
+        (4, 4, 0.0)
+    """
+    height, width = len(kernel), len(kernel[0])
+    # ignore the rounding noise of the decomposition
+    tol = 1e-9 * max(abs(x) for row in kernel for x in row)
+    if not rank:
+        values = [float(x) for row in kernel for x in row]
+        csds = allocate_nnz(values, budget, tol=tol)
+        flat, places = _integers(csds)
+        taps = [flat[i * width : (i + 1) * width] for i in range(height)]
+        keys = {_row_key(row)[0] for row in taps}
+        adders = mcm_block([x for key in keys for x in key]).adders()
+        adders += sum(map(summation_adders, keys))
+        adders += summation_adders([any(row) for row in taps])
+        plan = KernelPlan(0, places, taps, [], budget, adders, 0.0)
+    else:
+        triplets = low_rank(kernel, rank)
+        values: List[float] = []
+        weights: List[float] = []
+        for sigma, u, v in triplets:
+            # scale the column factor to a peak of one, which keeps integer
+            # factors integer, and weigh each tap by its largest partner
+            peak = max(u, key=abs)
+            us = [x / peak for x in u]
+            vs = [x * sigma * peak for x in v]
+            values += us + vs
+            weights += [max(map(abs, vs))] * height + [max(map(abs, us))] * width
+        csds = allocate_nnz(values, budget, weights, tol)
+        size = height + width
+        # a factor with a zero side contributes nothing
+        pairs = [
+            (csds[k : k + height], csds[k + height : k + size])
+            for k in range(0, len(csds), size)
+        ]
+        pairs = [
+            (u, v)
+            for u, v in pairs
+            if any(map(to_decimal, u)) and any(map(to_decimal, v))
+        ]
+        csds = [c for u, v in pairs for c in u + v]
+        us, u_places = _integers([c for u, _ in pairs for c in u])
+        vs, v_places = _integers([c for _, v in pairs for c in v])
+        factors = [
+            (us[k * height : (k + 1) * height], vs[k * width : (k + 1) * width])
+            for k in range(len(pairs))
+        ]
+        if factors:
+            adders = mcm_block([x for _, v in factors for x in v]).adders()
+            for u, v in factors:
+                adders += summation_adders(v) + mcm_block(u).adders()
+                adders += summation_adders(u)
+            adders += len(factors) - 1
+            shift = u_places + v_places
+            plan = KernelPlan(len(factors), shift, [], factors, budget, adders, 0.0)
+        else:  # the zero kernel, as a direct plan
+            taps = [[0] * width for _ in range(height)]
+            plan = KernelPlan(0, 0, taps, [], budget, 0, 0.0)
+    return plan._replace(
+        nnz=sum(c.count("+") + c.count("-") for c in csds),
+        max_error=_max_error(kernel, plan),
+    )
+
+
+def _row_filter(products: Dict[int, int], taps: Sequence[int], lane_bits: int) -> int:
+    """``sum(taps[c] * x[j + c])`` at lane ``j + len(taps) - 1``"""
+    last = len(taps) - 1
+    return sum(
+        _times(products, tap) << (lane_bits * (last - c)) for c, tap in enumerate(taps)
+    )
+
+
+def _times(products: Dict[int, int], tap: int) -> int:
+    return products[tap] if tap >= 0 else -products[-tap]
+
+
+def convolve2d(
+    plan: KernelPlan, image: Sequence[Sequence[int]], nbytes: int = 8
+) -> List[List[int]]:
+    """Filter an integer image by the shift-adds of a plan
+
+    Computes ``out[i][j] = sum(K[r][c] * image[i + r][j + c])`` over the
+    positions where the kernel fits the image, with the integer kernel of
+    the plan. Every output must stay below ``2**(8 * nbytes - 1)`` in
+    magnitude; `OverflowError` is raised when the largest pixel times the
+    sum of the tap magnitudes does not.
+
+    Examples:
+        >>> plan = plan_kernel([[1, 2], [2, 4]], 4, rank=1)
+        >>> convolve2d(plan, [[1, 0, 2], [0, 1, 3]])
+        [[5, 18]]
+    """
+    kernel = integer_kernel(plan)
+    height, width = len(kernel), len(kernel[0])
+    peak = max((abs(x) for row in image for x in row), default=0)
+    check_lanes(peak * sum(abs(x) for row in kernel for x in row), nbytes)
+    lane_bits = 8 * nbytes
+    count = len(image[0]) + width - 1
+    lines = [pack_lanes(list(row), nbytes) for row in image]
+    if plan.rank:
+        row_block = mcm_block([x for _, v in plan.factors for x in v])
+        column_blocks = [mcm_block(u) for u, _ in plan.factors]
+        columns = []  # the column products of every line, by factor
+        for line in lines:
+            products = row_block.products(line)
+            columns.append(
+                [
+                    block.products(_row_filter(products, v, lane_bits))
+                    for block, (_, v) in zip(column_blocks, plan.factors)
+                ]
+            )
+        outputs = [
+            sum(
+                _times(columns[i + r][k], tap)
+                for k, (u, _) in enumerate(plan.factors)
+                for r, tap in enumerate(u)
+            )
+            for i in range(len(lines) - height + 1)
+        ]
+    else:
+        rows = [_row_key(row) for row in plan.taps]
+        keys = {key for key, _, _ in rows}
+        block = mcm_block([x for key in keys for x in key])
+        filtered = []
+        for line in lines:
+            products = block.products(line)
+            filtered.append(
+                {key: _row_filter(products, key, lane_bits) for key in keys}
+            )
+        outputs = [
+            sum(
+                sign * (filtered[i + r][key] << shift)
+                for r, (key, sign, shift) in enumerate(rows)
+            )
+            for i in range(len(lines) - height + 1)
+        ]
+    return [
+        unpack_lanes(total, count, nbytes)[width - 1 : len(image[0])]
+        for total in outputs
+    ]
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
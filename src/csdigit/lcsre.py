@@ -40,6 +40,115 @@ def longest_repeated_substring(csd_str: str) -> str:
     return res
 
 
+def _has_repeat_of_length(csd_str: str, length: int) -> int:
+    """Return the start of a second non-overlapping occurrence, or -1
+
+    Every substring of the given length is hashed together with the start of
+    its first occurrence; any later occurrence starting at or beyond the end
+    of that first one is a non-overlapping repeat.
+    """
+    first = {}
+    for i in range(len(csd_str) - length + 1):
+        key = csd_str[i : i + length]
+        j = first.setdefault(key, i)
+        if i - j >= length:
+            return i
+    return -1
+
+
+def longest_repeated_substring_bounded(
+    csd_str: str, min_len: int = 1, max_len: int = -1
+) -> str:
+    """Longest non-overlapping repeat whose length lies in [min_len, max_len]
+
+    If a non-overlapping repeat of length L exists, so does one of every
+    shorter length (take a prefix of both occurrences), so the length can be
+    binary searched. The upper bound is tried first, and the search stops
+    there as soon as it succeeds.
+
+    Args:
+        csd_str (str): the CSD string
+        min_len (int): minimum length of the repeat
+        max_len (int): maximum length of the repeat (-1 for len(csd_str) // 2)
+
+    Returns:
+        str: the repeat, or "" if there is none within the bounds
+
+    Examples:
+        >>> longest_repeated_substring_bounded("+-00+-00+-00+-0")
+        '+-00+-0'
+        >>> longest_repeated_substring_bounded("+-00+-00+-00+-0", max_len=4)
+        '+-00'
+        >>> longest_repeated_substring_bounded("+-00+-00+-00+-0", min_len=8)
+        ''
+    """
+    half = len(csd_str) // 2
+    if max_len < 0 or max_len > half:
+        max_len = half
+    min_len = max(min_len, 1)
+    if min_len > max_len:
+        return ""
+
+    pos = _has_repeat_of_length(csd_str, max_len)
+    if pos >= 0:
+        return csd_str[pos : pos + max_len]
+
+    best, best_pos = 0, -1
+    lo, hi = min_len, max_len - 1
+    while lo <= hi:
+        mid = (lo + hi) // 2
+        pos = _has_repeat_of_length(csd_str, mid)
+        if pos >= 0:
+            best, best_pos = mid, pos
+            lo = mid + 1
+        else:
+            hi = mid - 1
+    if best == 0:
+        return ""
+    return csd_str[best_pos : best_pos + best]
+
+
+def has_repeated_nonzeros(csd_str: str, k: int, max_len: int = -1) -> bool:
+    """Check for a non-overlapping repeat containing at least k nonzeros
+
+    Any such repeat contains a minimal one that starts at a nonzero digit
+    and ends at the k-th nonzero digit after it. There are at most nnz of
+    these windows, so they are hashed in one left-to-right sweep that
+    returns at the first non-overlapping repeat.
+
+    Args:
+        csd_str (str): the CSD string
+        k (int): minimum number of nonzero digits in the repeat
+        max_len (int): maximum length of the repeat (-1 for unbounded)
+
+    Returns:
+        bool: True if such a repeat exists
+
+    Examples:
+        >>> has_repeated_nonzeros("+-00+-00+-00+-0", 4)
+        True
+        >>> has_repeated_nonzeros("+-00+-00+-00+-0", 5)
+        False
+        >>> has_repeated_nonzeros("+00+000+00+", 2, max_len=3)
+        False
+    """
+    if k <= 0:
+        return True
+    nz = [i for i, digit in enumerate(csd_str) if digit in "+-"]
+    if max_len < 0:
+        max_len = len(csd_str)
+    first = {}
+    for t in range(len(nz) - k + 1):
+        start, stop = nz[t], nz[t + k - 1] + 1
+        if stop - start > max_len:
+            continue
+        key = csd_str[start:stop]
+        prev_stop = first.setdefault(key, stop)
+        if start >= prev_stop:
+            return True
+    return False
+
+
 # Driver Code
 if __name__ == "__main__":
     csd_str = "+-00+-00+-00+-0"
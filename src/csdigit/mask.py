@@ -0,0 +1,203 @@
+"""
+CSD Mask Representation
+
+An integer CSD value is held as a pair of bit masks ``(pos, neg)``: bit i of
+`pos` is set for a ``+`` digit of weight 2**i, bit i of `neg` for a ``-``.
+The value is ``pos - neg``. Both masks come out of a few big-integer
+operations, and many values can be packed side by side into fixed-width
+lanes of one integer and converted all at once.
+
+Packed table format: one record per value, ``2 * nbytes`` bytes, little
+endian, with the `pos` mask in the low half and the `neg` mask in the high
+half.
+"""
+from typing import BinaryIO, Iterator, Tuple
+
+_POS_TABLE = str.maketrans("+-", "10")
+_NEG_TABLE = str.maketrans("+-", "01")
+
+
+def to_csd_mask(num: int) -> Tuple[int, int]:
+    """Convert the argument `num` to a pair of CSD masks
+
+    Args:
+        num (int): decimal value to be converted
+
+    Returns:
+        Tuple[int, int]: the `pos` and `neg` masks
+
+    Examples:
+        >>> to_csd_mask(28)
+        (32, 4)
+        >>> to_csd_mask(-28)
+        (4, 32)
+    """
+    absnum = abs(num)
+    half = absnum >> 1
+    three_half = absnum + half
+    diff = half ^ three_half
+    pos, neg = three_half & diff, half & diff
+    return (pos, neg) if num >= 0 else (neg, pos)
+
+
+def to_decimal_mask(pos: int, neg: int) -> int:
+    """Convert a pair of CSD masks to a decimal number
+
+    Examples:
+        >>> to_decimal_mask(32, 4)
+        28
+    """
+    return pos - neg
+
+
+def mask_to_csd(pos: int, neg: int, width: int = 0) -> str:
+    """Convert a pair of CSD masks to a string in the format of `to_csd_i`
+
+    The bit strings of both masks are read as big integers with one byte per
+    digit, so the characters are computed for all digits at once:
+    ``"0" - 5 * p - 3 * n`` gives ``"+"`` for p and ``"-"`` for n.
+
+    Args:
+        pos (int): the `pos` mask
+        neg (int): the `neg` mask
+        width (int): minimum number of digits, padded with leading zeros
+
+    Examples:
+        >>> mask_to_csd(32, 4)
+        '+00-00'
+        >>> mask_to_csd(0, 0)
+        '0'
+        >>> mask_to_csd(1, 0, 4)
+        '000+'
+    """
+    width = max(pos.bit_length(), neg.bit_length(), width)
+    if width == 0:
+        return "0"
+    fmt = "0{}b".format(width)
+    zero = int.from_bytes(b"0" * width, "big")
+    pbits = int.from_bytes(format(pos, fmt).encode(), "big") - zero
+    nbits = int.from_bytes(format(neg, fmt).encode(), "big") - zero
+    return (zero - 5 * pbits - 3 * nbits).to_bytes(width, "big").decode()
+
+
+def csd_to_mask(csd: str) -> Tuple[int, int]:
+    """Convert an integer CSD string to a pair of masks
+
+    Examples:
+        >>> csd_to_mask("+00-00")
+        (32, 4)
+    """
+    return int(csd.translate(_POS_TABLE), 2), int(csd.translate(_NEG_TABLE), 2)
+
+
+def lane_constants(count: int, lane_bits: int) -> Tuple[int, int]:
+    """Packed integers with every lane holding 1, and lane i holding i
+
+    Both are built by doubling, so the cost is a few big-integer operations
+    per power of two.
+
+    Examples:
+        >>> ones, iota = lane_constants(3, 8)
+        >>> hex(ones), hex(iota)
+        ('0x10101', '0x20100')
+    """
+    ones, iota, filled = 1, 0, 1
+    while filled < count:
+        shift = filled * lane_bits
+        iota |= (iota + ones * filled) << shift
+        ones |= ones << shift
+        filled *= 2
+    keep = (1 << (count * lane_bits)) - 1
+    return ones & keep, iota & keep
+
+
+def to_csd_mask_packed(packed: int, lane_bits: int, ones: int) -> Tuple[int, int]:
+    """Lane-wise `to_csd_mask` of non-negative values packed in one integer
+
+    Every value must be below ``2**(lane_bits - 2)`` so that the masks fit in
+    their lanes.
+
+    Args:
+        packed (int): the values, lane i at bits [i * lane_bits, ...)
+        lane_bits (int): width of a lane
+        ones (int): the first result of `lane_constants` for these lanes
+
+    Returns:
+        Tuple[int, int]: the packed `pos` and `neg` masks
+
+    Examples:
+        >>> ones, _ = lane_constants(2, 8)
+        >>> pos, neg = to_csd_mask_packed(28 | (3 << 8), 8, ones)
+        >>> (pos & 255, neg & 255), (pos >> 8, neg >> 8)
+        ((32, 4), (4, 1))
+    """
+    # clear the top bit of every lane, which a plain shift fills from the
+    # lane above
+    low = ones * ((1 << (lane_bits - 1)) - 1)
+    half = (packed >> 1) & low
+    three_half = packed + half
+    diff = half ^ three_half
+    return three_half & diff, half & diff
+
+
+def iter_csd_table(data: bytes, nbytes: int = 4) -> Iterator[Tuple[int, int]]:
+    """Iterate over the ``(pos, neg)`` records of a packed table
+
+    Examples:
+        >>> list(iter_csd_table(bytes([32, 4]), 1))
+        [(32, 4)]
+    """
+    record = 2 * nbytes
+    for offset in range(0, len(data) - record + 1, record):
+        pos = int.from_bytes(data[offset : offset + nbytes], "little")
+        neg = int.from_bytes(data[offset + nbytes : offset + record], "little")
+        yield pos, neg
+
+
+def write_csd_table(
+    fp: BinaryIO, start: int, stop: int, nbytes: int = 4, chunk: int = 1 << 16
+) -> int:
+    """Write the packed table of CSD masks for range(start, stop)
+
+    The values of a chunk are packed into the lanes of one integer, converted
+    by `to_csd_mask_packed` and serialized with a single ``to_bytes`` call.
+
+    Args:
+        fp (BinaryIO): binary file opened for writing
+        start (int): first value, non-negative
+        stop (int): one past the last value
+        nbytes (int): bytes per mask
+        chunk (int): number of values converted at once
+
+    Returns:
+        int: number of bytes written
+
+    Examples:
+        >>> import io
+        >>> buf = io.BytesIO()
+        >>> write_csd_table(buf, 27, 29, nbytes=1)
+        4
+        >>> list(iter_csd_table(buf.getvalue(), 1))
+        [(32, 5), (32, 4)]
+    """
+    bits = 8 * nbytes
+    if start < 0 or stop > 1 << (bits - 1):
+        raise ValueError("Range does not fit the table width")
+    lane_bits = 2 * bits
+    ones, iota = lane_constants(chunk, lane_bits)
+    written = 0
+    for base in range(start, stop, chunk):
+        count = min(chunk, stop - base)
+        if count < chunk:
+            ones, iota = lane_constants(count, lane_bits)
+        pos, neg = to_csd_mask_packed(base * ones + iota, lane_bits, ones)
+        size = count * 2 * nbytes
+        fp.write((pos | (neg << bits)).to_bytes(size, "little"))
+        written += size
+    return written
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,278 @@
+"""
+Online Signed-Digit Arithmetic
+
+Digit-serial operators that read signed-digit streams most significant
+digit first and produce the result MSB first after a fixed online delay.
+Input digit k (counting from 1) has weight 2**-k; output digit i (counting
+from 0) has weight 2**(top - i), where `top` is an attribute of the
+operator. The first output digit comes out with input digit `delay`, and
+one more with every input digit after that.
+
+Digits are pairs of masks ``(pos, neg)`` as in `to_csd_mask`, with bit s
+holding the digit of stream s, so one step of an operator advances any
+number of independent streams at once with a few big-integer operations.
+`simulate` converts between strings of ``+``, ``-`` and ``0`` and this
+bit-sliced form.
+
+The adder is the radix-2 carry-free one: the position sum z_j in [-2, 2]
+is split into a transfer t_j and an interim digit w_j with
+``z_j = 2 * t_j + w_j``, choosing the split by the sign of z_(j+1) so that
+``w_j + t_(j+1)`` is again a digit.
+"""
+import heapq
+from fractions import Fraction
+from time import perf_counter
+from typing import List, Optional, Sequence, Tuple
+
+from csdigit.mask import csd_to_mask, mask_to_csd
+from csdigit.sparse import to_sparse
+
+Digit = Tuple[int, int]  # (pos, neg) masks, one bit per stream
+
+_ZERO: Digit = (0, 0)
+
+
+class OnlineAdder:
+    """Online adder (or subtractor) of two signed-digit streams
+
+    The output has one more digit than the inputs, on top (``top == 0``).
+
+    Examples:
+        >>> simulate(OnlineAdder(), ["+0-"], ["++0"])
+        ['+0+-']
+        >>> simulate(OnlineAdder(subtract=True), ["+0-"], ["++0"])
+        ['0-+-']
+    """
+
+    delay = 2
+    top = 0
+
+    def __init__(self, subtract: bool = False):
+        self.subtract = subtract
+        self._z: Optional[Tuple[int, int, int, int]] = None
+        self._w: Optional[Digit] = None
+
+    def push(self, x: Digit, y: Digit) -> List[Digit]:
+        """Feed the next digits of both operands; returns the digits made"""
+        xp, xn = x
+        yn, yp = y if self.subtract else y[::-1]
+        # classify z = x + y: +2, -2, +1, -1 (anything else is zero)
+        p2, n2 = xp & yp, xn & yn
+        p1 = (xp ^ yp) & ~(xn | yn)
+        n1 = (xn ^ yn) & ~(xp | yp)
+        out = []
+        if self._z is not None:
+            neg_next = n2 | n1
+            zp2, zn2, zp1, zn1 = self._z
+            tp = zp2 | (zp1 & ~neg_next)
+            tn = zn2 | (zn1 & neg_next)
+            odd = zp1 | zn1
+            if self._w is None:
+                out.append((tp, tn))  # the transfer out of the top position
+            else:
+                wp, wn = self._w
+                out.append(((wp | tp) & ~(wn | tn), (wn | tn) & ~(wp | tp)))
+            self._w = (odd & neg_next, odd & ~neg_next)
+        self._z = (p2, n2, p1, n1)
+        return out
+
+    def flush(self) -> List[Digit]:
+        """End of both inputs: emit the remaining digits and reset"""
+        if self._z is None:
+            return [_ZERO]
+        out = self.push(_ZERO, _ZERO)
+        out.append(self._w)
+        self.__init__(self.subtract)
+        return out
+
+
+class _Node:
+    """Term of x (a leaf) or an online adder of two nodes, whose output is
+    preceded by `pad` zeros to align it with its sibling"""
+
+    def __init__(self, top: int, delay: int, lowest: int, sign: int = 0):
+        self.top = top
+        self.delay = delay
+        self.lowest = lowest  # the power of the lowest term below it
+        self.sign = sign
+        self.pad = 0
+        self.children: Tuple["_Node", ...] = ()
+        self.reset()
+
+    def reset(self):
+        self.started = False
+        self.adder = OnlineAdder()
+        self.queues: Tuple[List[Digit], List[Digit]] = ([], [])
+        for child in self.children:
+            child.reset()
+
+    def feed(self, x: Digit) -> List[Digit]:
+        if self.sign:
+            out = [x if self.sign > 0 else x[::-1]]
+        else:
+            qa, qb = self.queues
+            qa += self.children[0].feed(x)
+            qb += self.children[1].feed(x)
+            ready = min(len(qa), len(qb))
+            out = []
+            for a, b in zip(qa[:ready], qb[:ready]):
+                out += self.adder.push(a, b)
+            del qa[:ready], qb[:ready]
+        if not self.started:
+            self.started = True
+            out[:0] = [_ZERO] * self.pad
+        return out
+
+
+class OnlineConstantMultiplier:
+    """Online multiplication of a signed-digit stream by a CSD constant
+
+    Every non-zero digit of the constant is a shifted copy of the input.
+    The copies are summed by a tree of online adders, always joining the
+    two with the lowest weights first so that little-significant terms go
+    deep in the tree, where their extra delay is hidden by their shift.
+
+    Examples:
+        >>> mul = OnlineConstantMultiplier("+0-.+")
+        >>> mul.top, mul.delay
+        (2, 2)
+        >>> simulate(mul, ["0+"])
+        ['0+-00-']
+        >>> stream_value("0+-00-", mul.top)
+        Fraction(7, 8)
+    """
+
+    def __init__(self, csd: str):
+        terms = to_sparse(csd)
+        if not terms:
+            raise ValueError("Multiplication by zero")
+        heap = [
+            (power - 1, k, _Node(power - 1, 1, power, sign))
+            for k, (power, sign) in enumerate(terms)
+        ]
+        heapq.heapify(heap)
+        count = len(heap)
+        while len(heap) > 1:
+            _, _, low = heapq.heappop(heap)
+            _, _, high = heapq.heappop(heap)
+            low.pad = high.top - low.top
+            low.delay -= low.pad
+            node = _Node(
+                high.top + 1,
+                1 + max(low.delay, high.delay),
+                min(low.lowest, high.lowest),
+            )
+            node.children = (low, high)
+            heapq.heappush(heap, (node.top, count, node))
+            count += 1
+        self._root = heap[0][2]
+        self._root.reset()
+        self.top = self._root.top
+        self.delay = self._root.delay
+        self._count = 0
+
+    def push(self, x: Digit) -> List[Digit]:
+        """Feed the next input digit; returns the digits made"""
+        self._count += 1
+        return self._root.feed(x)
+
+    def flush(self) -> List[Digit]:
+        """End of the input: emit the remaining digits and reset"""
+        lowest = self._root.lowest - self._count
+        produced = 0 if self._count < self.delay else self._count - self.delay + 1
+        remaining = self.top - lowest + 1 - produced
+        out: List[Digit] = []
+        while len(out) < remaining:
+            out += self._root.feed(_ZERO)
+        self._root.reset()
+        self._count = 0
+        return out[:remaining]
+
+
+def pack_streams(streams: Sequence[str]) -> List[Digit]:
+    """Bit-slice equal-weight digit strings into one digit pair per position
+
+    Shorter strings are extended with zeros.
+
+    Examples:
+        >>> pack_streams(["+-", "0+0"])
+        [(1, 0), (2, 1), (0, 0)]
+    """
+    width = max(len(s) for s in streams)
+    columns = zip(*(s.ljust(width, "0") for s in streams))
+    return [csd_to_mask("".join(col)[::-1]) for col in columns]
+
+
+def unpack_streams(digits: Sequence[Digit], count: int) -> List[str]:
+    """Inverse of `pack_streams` for `count` streams
+
+    Examples:
+        >>> unpack_streams([(1, 0), (2, 1), (0, 0)], 2)
+        ['+-0', '0+0']
+    """
+    columns = [mask_to_csd(pos, neg).rjust(count, "0")[::-1] for pos, neg in digits]
+    return ["".join(row) for row in zip(*columns)] if columns else [""] * count
+
+
+def simulate(op, *inputs: Sequence[str]) -> List[str]:
+    """Run an operator over batches of digit strings, one batch per operand
+
+    The streams of each batch are advanced together, bit-sliced.
+
+    Examples:
+        >>> simulate(OnlineAdder(), ["+", "-", "0"], ["+", "+", "-"])
+        ['+0', '00', '0-']
+    """
+    count = len(inputs[0])
+    packed = [pack_streams(batch) for batch in inputs]
+    width = max(len(p) for p in packed)
+    for p in packed:
+        p += [_ZERO] * (width - len(p))
+    out: List[Digit] = []
+    for digits in zip(*packed):
+        out += op.push(*digits)
+    out += op.flush()
+    return unpack_streams(out, count)
+
+
+def stream_value(digits: str, top: int = -1) -> Fraction:
+    """Exact value of a digit string whose first digit has weight 2**top
+
+    Examples:
+        >>> stream_value("+0-")
+        Fraction(3, 8)
+    """
+    pos, neg = csd_to_mask(digits)
+    return Fraction(pos - neg) * Fraction(2) ** (top - len(digits) + 1)
+
+
+def measure(op, *inputs: Sequence[str], repeat: int = 3) -> Tuple[int, float]:
+    """Latency (input digits up to the first output digit) and throughput
+    (output digits per second, summed over the streams) of an operator
+
+    Examples:
+        >>> latency, rate = measure(OnlineAdder(), ["+0-"] * 8, ["0+-"] * 8)
+        >>> latency, rate > 0
+        (2, True)
+    """
+    count = len(inputs[0])
+    packed = list(zip(*(pack_streams(batch) for batch in inputs)))
+    latency = 0
+    best = float("inf")
+    for _ in range(repeat):
+        produced = 0
+        start = perf_counter()
+        for k, digits in enumerate(packed, 1):
+            made = len(op.push(*digits))
+            if made and not produced:
+                latency = k
+            produced += made
+        produced += len(op.flush())
+        best = min(best, perf_counter() - start)
+    return latency, produced * count / best
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
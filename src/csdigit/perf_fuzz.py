@@ -0,0 +1,234 @@
+"""
+Performance Fuzzing of the Conversion Functions
+
+Searches the inputs of `to_csd`, `to_csdfixed`, `to_decimal` and
+`longest_repeated_substring` for the ones that cost the most time (or peak
+memory) per unit of input size: the number of output digits, of non-zeros
+or of characters. Either a simple evolutionary search (`evolve`) or
+hypothesis' targeted search (`hypothesis_search`) drives the inputs. The
+slowest cases found can be saved as a JSON corpus, which the benchmark
+suite runs.
+"""
+import json
+import random
+import tracemalloc
+from math import frexp, ldexp
+from time import perf_counter
+from typing import Callable, Dict, List, NamedTuple, Sequence, Tuple
+
+from csdigit.csd import to_csd, to_csdfixed, to_decimal
+from csdigit.lcsre import longest_repeated_substring
+
+MAX_PLACES = 1024
+MAX_NNZ = 64
+MAX_LENGTH = 256
+MAX_EXPONENT = 300
+MIN_SIZE = 256  # smaller inputs are costed as if this large
+
+
+class Case(NamedTuple):
+    """An input of a function with its cost per unit of input size"""
+
+    name: str
+    args: tuple
+    cost: float
+
+
+def _random_float(rng: random.Random) -> float:
+    num = ldexp(rng.random() + 0.5, rng.randint(-60, 60))
+    return -num if rng.random() < 0.5 else num
+
+
+def _mutate_float(num: float, rng: random.Random) -> float:
+    exponent = frexp(num)[1]
+    choice = rng.randrange(4)
+    if choice == 0:  # just above or below a power of two
+        offset = rng.choice([-1.0, 1.0]) * ldexp(1.0, -rng.randint(1, 52))
+        result = ldexp(1.0 + offset, exponent)
+    elif choice == 1:  # flip a mantissa bit
+        result = num + ldexp(rng.choice([-1.0, 1.0]), exponent - rng.randint(1, 53))
+    elif choice == 2:  # change the magnitude
+        result = ldexp(num, rng.randint(-16, 16))
+    else:
+        result = _random_float(rng)
+    if result == 0.0 or not -MAX_EXPONENT < frexp(result)[1] < MAX_EXPONENT:
+        return _random_float(rng)
+    return result
+
+
+def _mutate_string(csd: str, rng: random.Random, dot: bool) -> str:
+    digits = list(csd.replace(".", "")) or ["0"]
+    choice = rng.randrange(4)
+    if choice == 0:
+        digits[rng.randrange(len(digits))] = rng.choice("+-0")
+    elif choice == 1:
+        digits.insert(rng.randrange(len(digits) + 1), rng.choice("+-0"))
+    elif choice == 2 and len(digits) > 1:
+        del digits[rng.randrange(len(digits))]
+    else:  # repeat a chunk, the worst case for repeat searches
+        i = rng.randrange(len(digits))
+        digits += digits[i : i + rng.randint(1, 16)]
+    digits = digits[:MAX_LENGTH]
+    if dot:
+        digits.insert(rng.randrange(len(digits) + 1), ".")
+    return "".join(digits)
+
+
+def _random_string(rng: random.Random) -> str:
+    return "".join(rng.choice("+-0") for _ in range(rng.randint(1, 64)))
+
+
+def _clamp(value: int, lo: int, hi: int) -> int:
+    return min(max(value, lo), hi)
+
+
+# name: (function, size of the arguments, random arguments, mutation)
+TARGETS: Dict[str, Tuple[Callable, Callable, Callable, Callable]] = {
+    "to_csd": (
+        to_csd,
+        lambda num, places: places + max(frexp(num)[1], 1),
+        lambda rng: (_random_float(rng), rng.randint(0, 64)),
+        lambda args, rng: (
+            (_mutate_float(args[0], rng), args[1])
+            if rng.random() < 0.5
+            else (args[0], _clamp(args[1] + rng.randint(-64, 64), 0, MAX_PLACES))
+        ),
+    ),
+    "to_csdfixed": (
+        to_csdfixed,
+        lambda num, nnz: nnz,
+        lambda rng: (_random_float(rng), rng.randint(1, 16)),
+        lambda args, rng: (
+            (_mutate_float(args[0], rng), args[1])
+            if rng.random() < 0.5
+            else (args[0], _clamp(args[1] + rng.randint(-4, 4), 1, MAX_NNZ))
+        ),
+    ),
+    "to_decimal": (
+        to_decimal,
+        len,
+        lambda rng: (_random_string(rng) + "." + _random_string(rng),),
+        lambda args, rng: (_mutate_string(args[0], rng, True),),
+    ),
+    "longest_repeated_substring": (
+        longest_repeated_substring,
+        len,
+        lambda rng: (_random_string(rng),),
+        lambda args, rng: (_mutate_string(args[0], rng, False),),
+    ),
+}
+
+
+def measure(name: str, args: tuple, metric: str = "time", repeat: int = 3) -> float:
+    """Best-of-`repeat` seconds, or peak bytes allocated, per unit of size
+
+    Sizes below `MIN_SIZE` count as `MIN_SIZE`. Otherwise the fixed
+    overhead of a call would make the smallest inputs look the costliest,
+    and the search would never grow them.
+
+    Examples:
+        >>> measure("to_csd", (28.5, 2)) > 0.0
+        True
+    """
+    func, size_of, _, _ = TARGETS[name]
+    size = max(size_of(*args), MIN_SIZE)
+    if metric == "memory":
+        tracemalloc.start()
+        try:
+            func(*args)
+            peak = tracemalloc.get_traced_memory()[1]
+        finally:
+            tracemalloc.stop()
+        return peak / size
+    if metric != "time":
+        raise ValueError("Metric is time or memory")
+    best = float("inf")
+    for _ in range(repeat):
+        start = perf_counter()
+        func(*args)
+        best = min(best, perf_counter() - start)
+    return best / size
+
+
+def evolve(
+    name: str,
+    generations: int = 20,
+    population: int = 16,
+    metric: str = "time",
+    seed: int = 0,
+) -> List[Case]:
+    """Evolutionary search for the costliest inputs of a function
+
+    Every generation, each survivor produces one mutant, and the costliest
+    half of survivors and mutants is kept.
+
+    Returns:
+        List[Case]: the final population, costliest first
+
+    Examples:
+        >>> cases = evolve("to_decimal", generations=2, population=4)
+        >>> len(cases), cases[0].cost >= cases[-1].cost
+        (4, True)
+    """
+    _, _, sample, mutate = TARGETS[name]
+    rng = random.Random(seed)
+
+    def case(args: tuple) -> Case:
+        return Case(name, args, measure(name, args, metric))
+
+    cases = [case(sample(rng)) for _ in range(population)]
+    for _ in range(generations):
+        cases += [case(mutate(c.args, rng)) for c in cases]
+        cases = sorted(cases, key=lambda c: -c.cost)[:population]
+    return cases
+
+
+def hypothesis_search(
+    name: str, max_examples: int = 100, metric: str = "time"
+) -> List[Case]:
+    """Let hypothesis' targeted search maximize the cost; returns the
+    costliest inputs it tried, costliest first"""
+    from hypothesis import given, settings, target
+    from hypothesis import strategies as st
+
+    samples = st.randoms(use_true_random=False).map(TARGETS[name][2])
+    found: List[Case] = []
+
+    @settings(max_examples=max_examples, deadline=None, database=None)
+    @given(samples)
+    def run(args):
+        cost = measure(name, args, metric)
+        found.append(Case(name, args, cost))
+        target(cost)
+
+    run()
+    return sorted(found, key=lambda c: -c.cost)
+
+
+def save_corpus(path: str, cases: Sequence[Case], per_function: int = 4):
+    """Save the costliest cases of each function as JSON, each input once"""
+    corpus: Dict[str, List[dict]] = {}
+    for c in sorted(cases, key=lambda c: -c.cost):
+        entries = corpus.setdefault(c.name, [])
+        args = list(c.args)
+        if len(entries) < per_function and all(e["args"] != args for e in entries):
+            entries.append({"args": args, "cost": c.cost})
+    with open(path, "w") as fp:
+        json.dump(corpus, fp, indent=2, sort_keys=True)
+
+
+def load_corpus(path: str) -> List[Case]:
+    """Read a corpus written by `save_corpus`"""
+    with open(path) as fp:
+        corpus = json.load(fp)
+    return [
+        Case(name, tuple(entry["args"]), entry["cost"])
+        for name, entries in sorted(corpus.items())
+        for entry in entries
+    ]
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,218 @@
+"""
+Polyphase Filter Banks
+
+A decimator or interpolator by M splits its prototype filter h into the M
+phases ``e_p = h[p::M]``. In an interpolator, every phase filters the same
+input sample; in a decimator in transposed form, the commutated input
+sample feeds one phase at a time, so a single shift-add block can serve
+all of them. Either way, one constant set holds the taps of all phases,
+and its common subexpressions are extracted once rather than per phase.
+
+The prototype is quantized by `to_csd`, folding linear-phase symmetry, so
+each distinct tap is converted once. `Decimator` and `Interpolator` run a
+plan bit-true on blocks of integer samples, keeping the filter state
+between blocks. Within a block, the samples of a phase are packed in the
+lanes of one integer: a multiplication by the shift-adds of the plan
+covers the whole block, and a delay is a shift by a lane.
+"""
+from math import ldexp
+from typing import Dict, List, NamedTuple, Sequence, TypeVar
+
+from csdigit.csd import to_csd, to_decimal
+from csdigit.cse import McmBlock, Pattern, Term, mcm_block, summation_adders
+from csdigit.rb_adder import check_lanes, pack_lanes, unpack_lanes
+from csdigit.symmetry import map_symmetric, negate_csd
+
+T = TypeVar("T")
+
+
+def decompose(taps: Sequence[T], factor: int) -> List[List[T]]:
+    """Phases of a prototype filter
+
+    Examples:
+        >>> decompose([1, 2, 3, 4, 5], 2)
+        [[1, 3, 5], [2, 4]]
+    """
+    if factor < 1:
+        raise ValueError("Factor must be positive")
+    return [list(taps[p::factor]) for p in range(factor)]
+
+
+def recompose(phases: Sequence[Sequence[T]]) -> List[T]:
+    """The prototype filter of its phases
+
+    Examples:
+        >>> recompose([[1, 3, 5], [2, 4]])
+        [1, 2, 3, 4, 5]
+    """
+    length = sum(map(len, phases))
+    factor = len(phases)
+    return [phases[n % factor][n // factor] for n in range(length)]
+
+
+def quantize_phases(taps: Sequence[float], factor: int, places: int) -> List[List[str]]:
+    """`to_csd` of the phases of a prototype filter
+
+    Examples:
+        >>> quantize_phases([0.25, 0.75, 0.75, 0.25], 2, 2)
+        [['0.0+', '0.++'], ['0.++', '0.0+']]
+    """
+    return decompose(
+        map_symmetric(lambda c: to_csd(c, places), taps, negate_csd), factor
+    )
+
+
+class PhasePlan(NamedTuple):
+    """Integer phases ``e_p * 2**places`` and the shift-adds of their taps
+
+    `constants` are the distinct tap magnitudes of all phases, built by
+    `subexprs` and `terms` as in `extract_common_subexpressions`.
+    """
+
+    phases: List[List[int]]
+    places: int
+    constants: List[int]
+    subexprs: List[Pattern]
+    terms: List[List[Term]]
+    adders: int  # shared constant block and the phase filters
+    separate_adders: int  # with a constant block per phase
+
+
+def plan_polyphase(taps: Sequence[float], factor: int, places: int) -> PhasePlan:
+    """Quantize a prototype filter and share subexpressions across phases
+
+    Examples:
+        >>> taps = [0.125, 0.375, 0.625, 0.875, 0.875, 0.625, 0.375, 0.125]
+        >>> plan = plan_polyphase(taps, 2, 3)
+        >>> plan.phases
+        [[1, 5, 7, 3], [3, 7, 5, 1]]
+        >>> plan.adders, plan.separate_adders
+        (10, 13)
+    """
+    phases = [
+        [round(ldexp(to_decimal(csd), places)) for csd in phase]
+        for phase in quantize_phases(taps, factor, places)
+    ]
+    block = mcm_block([c for phase in phases for c in phase])
+    structural = sum(map(summation_adders, phases))
+    structural += summation_adders([any(phase) for phase in phases])
+    return PhasePlan(
+        phases,
+        places,
+        block.constants,
+        block.subexprs,
+        block.terms,
+        block.adders() + structural,
+        sum(mcm_block(phase).adders() for phase in phases) + structural,
+    )
+
+
+def _filter_lanes(products: Dict[int, int], taps: Sequence[int], lane_bits: int) -> int:
+    """``sum(taps[j] * z[m - j])`` at lane ``m`` of the packed samples z"""
+    total = 0
+    for j, tap in enumerate(taps):
+        if tap:
+            term = products[abs(tap)] << (lane_bits * j)
+            total += term if tap > 0 else -term
+    return total
+
+
+class _PhaseFilter:
+    """Shared state of the block simulators; samples and products travel in
+    lanes of `nbytes` bytes, and `OverflowError` is raised for a block whose
+    largest sample times the largest tap magnitude sum of a phase does not
+    fit a lane"""
+
+    def __init__(self, plan: PhasePlan, nbytes: int = 8):
+        self.plan = plan
+        self.nbytes = nbytes
+        self.factor = len(plan.phases)
+        self.span = max(map(len, plan.phases))  # taps of the longest phase
+        self.gain = max(sum(map(abs, phase)) for phase in plan.phases)
+        self.reset()
+
+    def reset(self):
+        self.history: List[int] = []
+        self.seen = 0
+
+    def _check(self, samples: Sequence[int]):
+        check_lanes(max(map(abs, samples), default=0) * self.gain, self.nbytes)
+
+    def _products(self, samples: Sequence[int]) -> Dict[int, int]:
+        plan = self.plan
+        block = McmBlock(plan.constants, plan.subexprs, plan.terms)
+        return block.products(pack_lanes(samples, self.nbytes))
+
+    def _filter(self, samples: Sequence[int], products, phase: Sequence[int]):
+        """The outputs of a phase at lanes past its `span` - 1 of history"""
+        total = _filter_lanes(products, phase, 8 * self.nbytes)
+        lanes = unpack_lanes(total, len(samples) + self.span, self.nbytes)
+        return lanes[self.span - 1 : len(samples)]
+
+
+class Decimator(_PhaseFilter):
+    """Bit-true decimation by the factor of a plan, block by block
+
+    Output m is ``sum(h[k] * x[m * M - k])`` with the integer prototype
+    h, that is in units of ``2**-places``.
+
+    Examples:
+        >>> plan = plan_polyphase([0.25, 0.5, 0.25], 2, 2)
+        >>> dec = Decimator(plan)
+        >>> dec.process([4, 8, 4]), dec.process([0, 4, 4, 4])
+        ([4, 24], [8, 16])
+    """
+
+    def reset(self):
+        super().reset()
+        self.history = [0] * (self.span * self.factor)
+
+    def process(self, block: Sequence[int]) -> List[int]:
+        factor = self.factor
+        buf = self.history + list(block)
+        self._check(buf)
+        first = len(self.history) + (-self.seen) % factor
+        count = len(range(first, len(buf), factor))
+        total = [0] * count
+        for p, phase in enumerate(self.plan.phases):
+            # z[q] = x[n - p] at the output samples n, with the history
+            start = first - p - (self.span - 1) * factor
+            z = buf[start : start + (count + self.span - 1) * factor : factor]
+            outputs = self._filter(z, self._products(z), phase)
+            total = [a + b for a, b in zip(total, outputs)]
+        self.seen += len(block)
+        self.history = buf[len(buf) - len(self.history) :]
+        return total
+
+
+class Interpolator(_PhaseFilter):
+    """Bit-true interpolation by the factor of a plan, block by block
+
+    Output ``m * M + p`` is ``sum(e_p[j] * x[m - j])``, the prototype
+    filter applied to the input upsampled by M.
+
+    Examples:
+        >>> plan = plan_polyphase([0.25, 0.5, 0.25], 2, 2)
+        >>> Interpolator(plan).process([4, 8])
+        [4, 8, 12, 16]
+    """
+
+    def reset(self):
+        super().reset()
+        self.history = [0] * (self.span - 1)
+
+    def process(self, block: Sequence[int]) -> List[int]:
+        buf = self.history + list(block)
+        self._check(buf)
+        # one multiplication by all constants serves every phase
+        products = self._products(buf)
+        outputs = [self._filter(buf, products, phase) for phase in self.plan.phases]
+        self.seen += len(block)
+        self.history = buf[len(block) :]
+        return [y for ys in zip(*outputs) for y in ys]
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
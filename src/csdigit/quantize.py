@@ -0,0 +1,212 @@
+"""
+Vector Quantization to CSD
+
+Quantizing every coefficient of a filter independently lets the errors add
+up in the frequency response. The error-feedback quantizer below subtracts
+a filtered copy of the previous quantization errors before converting each
+coefficient. The feedback acts one coefficient late, so the total error is
+the sequence of quantization errors shaped by ``1 - z**-1 * F(z)``.
+
+Alternatively the whole vector can be scaled by a constant before the
+conversion and the scale undone at the output; `scale_search` looks for
+scales that make the digits sparse.
+"""
+from cmath import exp, pi
+from functools import lru_cache
+from math import sqrt
+from typing import List, Optional, Sequence, Tuple
+
+from csdigit.csd import to_csd, to_csdfixed, to_decimal
+from csdigit.mask import lane_constants, to_csd_mask_packed
+
+
+def _quantizer(places: Optional[int], nnz: Optional[int]):
+    if (places is None) == (nnz is None):
+        raise ValueError("Give exactly one of places or nnz")
+    if nnz is not None:
+        return lambda num: to_csdfixed(num, nnz)
+    return lambda num: to_csd(num, places)
+
+
+def to_csd_shaped(
+    coeffs: Sequence[float],
+    places: Optional[int] = None,
+    nnz: Optional[int] = None,
+    feedback: Sequence[float] = (1.0,),
+) -> Tuple[List[str], List[float]]:
+    """Quantize a coefficient vector to CSD with error feedback
+
+    Before coefficient n is converted, ``sum(feedback[k] * e[n - 1 - k])`` is
+    subtracted from it, where ``e`` holds the errors made so far. With the
+    default feedback ``(1.0,)`` the total error has the first-order highpass
+    shape ``1 - z**-1``; an empty feedback gives plain independent
+    quantization.
+
+    Args:
+        coeffs (Sequence[float]): the coefficients
+        places (int, optional): number of fractional places, as in `to_csd`
+        nnz (int, optional): number of non-zeros, as in `to_csdfixed`
+        feedback (Sequence[float]): taps of the error-feedback filter F
+
+    Returns:
+        Tuple[List[str], List[float]]: CSD strings and their values
+
+    Examples:
+        >>> to_csd_shaped([0.3, 0.3, 0.3], places=2)
+        (['0.0+', '0.+0', '0.00'], [0.25, 0.5, 0.0])
+    """
+    quantize = _quantizer(places, nnz)
+    order = len(feedback)
+    errors = [0.0] * order  # most recent first
+    csds = []
+    values = []
+    for coeff in coeffs:
+        target = coeff - sum(f * e for f, e in zip(feedback, errors))
+        csd = quantize(target)
+        value = to_decimal(csd)
+        csds.append(csd)
+        values.append(value)
+        if order:
+            errors = [value - target] + errors[:-1]
+    return csds, values
+
+
+@lru_cache(maxsize=32)
+def _twiddles(length: int, npoints: int) -> Tuple[Tuple[complex, ...], ...]:
+    return tuple(
+        tuple(exp(-1j * pi * k * n / npoints) for n in range(length))
+        for k in range(npoints)
+    )
+
+
+def spectral_error(
+    coeffs: Sequence[float], values: Sequence[float], npoints: int = 64
+) -> Tuple[float, float]:
+    """Peak and RMS magnitude of the frequency response error
+
+    The error response is sampled at `npoints` frequencies evenly spaced on
+    [0, pi). For `to_csd_shaped`, it is the response of the quantization
+    errors times ``1 - z**-1 * F(z)``, small where that shaping is. The
+    complex exponentials are cached per (length, npoints), so repeated
+    calls on vectors of the same length only pay for the dot products.
+
+    Args:
+        coeffs (Sequence[float]): the original coefficients
+        values (Sequence[float]): the quantized coefficients
+        npoints (int): number of frequency samples
+
+    Returns:
+        Tuple[float, float]: peak and RMS error magnitude
+
+    Examples:
+        >>> spectral_error([0.5, 0.25], [0.5, 0.25])
+        (0.0, 0.0)
+    """
+    diff = [v - c for c, v in zip(coeffs, values)]
+    mags = [
+        abs(sum(d * w for d, w in zip(diff, row)))
+        for row in _twiddles(len(diff), npoints)
+    ]
+    return max(mags), sqrt(sum(m * m for m in mags) / npoints)
+
+
+def to_csd_shaped_batch(
+    vectors: Sequence[Sequence[float]],
+    places: Optional[int] = None,
+    nnz: Optional[int] = None,
+    feedback: Sequence[float] = (1.0,),
+    npoints: int = 64,
+) -> List[Tuple[List[str], List[float], float, float]]:
+    """Error-feedback quantization of many coefficient vectors
+
+    Args:
+        vectors (Sequence[Sequence[float]]): the coefficient vectors
+        places (int, optional): number of fractional places, as in `to_csd`
+        nnz (int, optional): number of non-zeros, as in `to_csdfixed`
+        feedback (Sequence[float]): taps of the error-feedback filter F
+        npoints (int): number of frequency samples for the error metrics
+
+    Returns:
+        List[Tuple[List[str], List[float], float, float]]: for each vector,
+            the CSD strings, their values, and the peak and RMS spectral
+            errors
+
+    Examples:
+        >>> res = to_csd_shaped_batch([[0.3, 0.3], [0.5, 0.25]], places=2)
+        >>> [r[0] for r in res]
+        [['0.0+', '0.+0'], ['0.+0', '0.0+']]
+    """
+    results = []
+    for coeffs in vectors:
+        csds, values = to_csd_shaped(coeffs, places, nnz, feedback)
+        peak, rms = spectral_error(coeffs, values, npoints)
+        results.append((csds, values, peak, rms))
+    return results
+
+
+def scale_search(
+    coeffs: Sequence[float],
+    places: int,
+    lo: float = 0.5,
+    hi: float = 1.0,
+    step: float = 2**-10,
+) -> List[Tuple[float, int, float]]:
+    """Pareto set of scales trading the total non-zero digits for accuracy
+
+    For every scale s in [lo, hi] with the given step, each ``s * c`` is
+    rounded to the nearest multiple of ``2**-places``. The magnitudes for all
+    scales and taps are packed into the lanes of one integer and converted
+    by a single `to_csd_mask_packed`; the digits of a scale are then counted
+    on its slice of the lanes. The error of a tap is measured after undoing
+    the scale, ``|q / s - c|``.
+
+    Args:
+        coeffs (Sequence[float]): the coefficients
+        places (int): number of fractional places
+        lo (float): smallest scale
+        hi (float): largest scale
+        step (float): scale increment
+
+    Returns:
+        List[Tuple[float, int, float]]: ``(scale, total nnz, max error)``
+            for every scale not beaten on both counts by another, by
+            increasing nnz
+
+    Examples:
+        >>> front = scale_search([0.3, 0.7, 0.45], 4, 0.5, 1.0, 1 / 16)
+        >>> [(s, nnz) for s, nnz, _ in front]
+        [(0.75, 4), (0.8125, 5)]
+    """
+    if step <= 0.0 or hi < lo or not coeffs:
+        raise ValueError("Empty search")
+    scales = [lo + k * step for k in range(int((hi - lo) / step + 1e-9) + 1)]
+    unit = 2.0**places
+    ntaps = len(coeffs)
+    quantized = [round(s * c * unit) for s in scales for c in coeffs]
+    mags = [abs(q) for q in quantized]
+    nbytes = (max(mags).bit_length() + 2 + 7) // 8
+    lane_bits = 8 * nbytes
+    ones, _ = lane_constants(len(mags), lane_bits)
+    packed = int.from_bytes(
+        b"".join(m.to_bytes(nbytes, "little") for m in mags), "little"
+    )
+    pos, neg = to_csd_mask_packed(packed, lane_bits, ones)
+    size = ntaps * nbytes
+    digits = (pos | neg).to_bytes(len(mags) * nbytes, "little")
+    candidates = []
+    for k, s in enumerate(scales):
+        nnz = bin(int.from_bytes(digits[k * size : (k + 1) * size], "little"))
+        row = quantized[k * ntaps : (k + 1) * ntaps]
+        error = max(abs(q / (s * unit) - c) for q, c in zip(row, coeffs))
+        candidates.append((nnz.count("1"), error, s))
+    front = []
+    for nnz, error, s in sorted(candidates):
+        if not front or error < front[-1][2]:
+            front.append((s, nnz, error))
+    return front
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,161 @@
+"""
+Exact Periodic CSD Expansion of Rationals
+
+The CSD expansion of a rational number is eventually periodic. Running the
+`to_csd` recurrence on the scaled remainder ``v = r * 2**k`` keeps a fixed
+denominator ``q``, so the whole state is one bounded integer ``a = v * q``.
+The first time a state repeats, the expansion has been found in full.
+"""
+from fractions import Fraction
+from typing import Tuple, Union
+
+from csdigit.csd import to_decimal_i
+
+Rational = Union[int, Fraction]
+
+
+def _ceil_log2(value: Fraction) -> int:
+    """Smallest e such that 2**e >= value (value > 0)"""
+    e = value.numerator.bit_length() - value.denominator.bit_length()
+    while Fraction(2) ** e < value:
+        e += 1
+    while Fraction(2) ** (e - 1) >= value:
+        e -= 1
+    return e
+
+
+def to_csd_periodic(num: Rational) -> Tuple[str, str]:
+    """Convert a rational to an exact (prefix, repeating block) CSD form
+
+    The digits are those `to_csd` would emit for the exact value: the prefix
+    holds the integer digits, the point and the pre-period, and the repeating
+    block recurs forever after it. A terminating expansion has an empty block.
+    The cost depends on the period only, not on how many digits are used.
+
+    Args:
+        num (Rational): an int or a `Fraction`
+
+    Returns:
+        Tuple[str, str]: the prefix and the repeating block
+
+    Examples:
+        >>> to_csd_periodic(Fraction(1, 3))
+        ('0.', '0+')
+        >>> to_csd_periodic(Fraction(-1, 7))
+        ('0.', '00-')
+        >>> to_csd_periodic(Fraction(57, 2))
+        ('+00-00.+', '')
+        >>> to_csd_periodic(28)
+        ('+00-00', '')
+    """
+    num = Fraction(num)
+    if num == 0:
+        return "0", ""
+
+    absnum = abs(num)
+    if absnum < 1:
+        p2n = Fraction(1)
+        csd = "0"
+    else:
+        p2n = Fraction(2) ** _ceil_log2(absnum * Fraction(3, 2))
+        csd = ""
+    while p2n > 1:
+        p2n /= 2
+        det = num * Fraction(3, 2)
+        if det > p2n:
+            csd += "+"
+            num -= p2n
+        elif det < -p2n:
+            csd += "-"
+            num += p2n
+        else:
+            csd += "0"
+
+    if num == 0:
+        return csd, ""
+
+    # state before the k-th fractional digit: v = num * 2**k = a / q
+    start = num * 2
+    a, q = start.numerator, start.denominator
+    digits = []
+    seen = {}
+    while a != 0 and a not in seen:
+        seen[a] = len(digits)
+        det = 3 * a
+        if det > 2 * q:
+            digits.append("+")
+            a -= q
+        elif det < -2 * q:
+            digits.append("-")
+            a += q
+        else:
+            digits.append("0")
+        a *= 2
+
+    frac = "".join(digits)
+    if a == 0:
+        return csd + "." + frac, ""
+    mark = seen[a]
+    return csd + "." + frac[:mark], frac[mark:]
+
+
+def expand_periodic(prefix: str, repeat: str, places: int) -> str:
+    """Expand a periodic CSD form to a fixed number of fractional places
+
+    Args:
+        prefix (str): the prefix from `to_csd_periodic`
+        repeat (str): the repeating block from `to_csd_periodic`
+        places (int): number of fractional places
+
+    Returns:
+        str: the CSD string, in the format of `to_csd`
+
+    Examples:
+        >>> expand_periodic("0.", "0+", 6)
+        '0.0+0+0+'
+        >>> expand_periodic("+00-00.+", "", 2)
+        '+00-00.+0'
+    """
+    loc = prefix.find(".")
+    if loc < 0:
+        prefix += "."
+        loc = len(prefix) - 1
+    need = places - (len(prefix) - loc - 1)
+    if need <= 0:
+        return prefix[: loc + 1 + places] if places > 0 else prefix[:loc]
+    if repeat:
+        tail = repeat * (need // len(repeat) + 1)
+    else:
+        tail = "0" * need
+    return prefix + tail[:need]
+
+
+def to_fraction(prefix: str, repeat: str = "") -> Fraction:
+    """Convert a periodic CSD form back to an exact `Fraction`
+
+    Args:
+        prefix (str): integer digits, point and pre-period
+        repeat (str): the repeating block
+
+    Returns:
+        Fraction: the exact value
+
+    Examples:
+        >>> to_fraction("0.", "0+")
+        Fraction(1, 3)
+        >>> to_fraction("+00-00.+")
+        Fraction(57, 2)
+    """
+    integer, _, frac = prefix.partition(".")
+    places = len(frac)
+    value = Fraction(to_decimal_i(integer + frac), 2**places)
+    if repeat:
+        period = len(repeat)
+        value += Fraction(to_decimal_i(repeat), (2**period - 1) * 2**places)
+    return value
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
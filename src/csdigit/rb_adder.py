@@ -0,0 +1,233 @@
+"""
+Redundant-Binary Adder Arrays
+
+Signed-digit operands are packed side by side into lanes of two big
+integers, the ``(pos, neg)`` masks of `to_csd_mask`, with lane i at bits
+[i * 8 * nbytes, ...). A carry-free addition then processes every digit of
+every lane with a dozen big-integer operations: the position sum z_i in
+[-2, 2] is split into a transfer into position i + 1 and an interim digit
+with ``z_i = 2 * t_(i+1) + w_i``, choosing the split by the sign of z_(i-1)
+so that ``w_i + t_i`` is again a digit. No transfer travels more than one
+position, as in the hardware.
+
+Each addition may grow the magnitude by one bit, so the operands must leave
+one guard bit per level of an adder tree below the sign bit of a lane; a
+transfer out of a lane raises `OverflowError` instead of spilling into the
+next one.
+"""
+import sys
+from array import array
+from functools import lru_cache
+from typing import List, NamedTuple, Sequence, Tuple
+
+from csdigit.mask import lane_constants, to_csd_mask_packed
+
+
+# signed array type codes by item size, for converting lanes in C
+_CODES = {array(code).itemsize: code for code in "bhilq"}
+
+
+def _to_bytes(values, nbytes: int) -> bytes:
+    code = _CODES.get(nbytes)
+    if code is None:
+        return b"".join(v.to_bytes(nbytes, "little", signed=True) for v in values)
+    arr = array(code, values)
+    if sys.byteorder == "big":
+        arr.byteswap()
+    return arr.tobytes()
+
+
+def _from_bytes(data: bytes, nbytes: int) -> List[int]:
+    code = _CODES.get(nbytes)
+    if code is None:
+        return [
+            int.from_bytes(data[i : i + nbytes], "little", signed=True)
+            for i in range(0, len(data), nbytes)
+        ]
+    arr = array(code, data)
+    if sys.byteorder == "big":
+        arr.byteswap()
+    return arr.tolist()
+
+
+class RbVector(NamedTuple):
+    """Packed signed digits of `count` lanes of `nbytes` bytes each"""
+
+    pos: int
+    neg: int
+    nbytes: int
+    count: int
+
+
+@lru_cache(maxsize=16)
+def _layout(count: int, nbytes: int) -> Tuple[int, int, int]:
+    """Every lane's bit 0, every lane's top bit, every lane but its bit 0"""
+    lane_bits = 8 * nbytes
+    ones, _ = lane_constants(count, lane_bits)
+    top = ones << (lane_bits - 1)
+    return ones, top, ones * ((1 << lane_bits) - 2)
+
+
+def pack_values(values: Sequence[int], nbytes: int = 4) -> RbVector:
+    """CSD digits of signed integers, one lane each
+
+    Every magnitude must be below ``2**(8 * nbytes - 2)``.
+
+    Examples:
+        >>> v = pack_values([28, -3], 1)
+        >>> (v.pos & 255, v.neg & 255), (v.pos >> 8, v.neg >> 8)
+        ((32, 4), (1, 4))
+    """
+    count = len(values)
+    lane_bits = 8 * nbytes
+    limit = 1 << (lane_bits - 2)
+    if values and not -limit < min(values) <= max(values) < limit:
+        raise ValueError("Value does not fit the lane width")
+    ones, _, _ = _layout(count, nbytes)
+    mags = int.from_bytes(_to_bytes(map(abs, values), nbytes), "little")
+    pos, neg = to_csd_mask_packed(mags, lane_bits, ones)
+    signs = bytearray(count * nbytes)
+    signs[::nbytes] = bytes(map((0).__gt__, values))
+    lanes = int.from_bytes(signs, "little") * ((1 << lane_bits) - 1)
+    swap = (pos ^ neg) & lanes
+    return RbVector(pos ^ swap, neg ^ swap, nbytes, count)
+
+
+def pack_lanes(values: Sequence[int], nbytes: int = 8) -> int:
+    """Signed integers as the single integer ``sum(v << (8 * nbytes * i))``
+
+    Shifts, sums and differences of such integers act on every lane at
+    once, as long as each lane stays below ``2**(8 * nbytes - 1)`` in
+    magnitude; `unpack_lanes` reads the lanes back.
+
+    Examples:
+        >>> x = pack_lanes([3, -5], 1)
+        >>> unpack_lanes((x << 2) - x, 2, 1)
+        [9, -15]
+    """
+    lane_bits = 8 * nbytes
+    signs = bytearray(len(values) * nbytes)
+    signs[::nbytes] = bytes(map((0).__gt__, values))
+    borrows = int.from_bytes(signs, "little") << lane_bits
+    return int.from_bytes(_to_bytes(values, nbytes), "little") - borrows
+
+
+def check_lanes(bound: int, nbytes: int = 8):
+    """Raise `OverflowError` unless lane values up to `bound` in magnitude
+    fit a lane
+
+    Sums, differences and shifts of packed integers are exact whatever
+    their intermediate lane values, but `unpack_lanes` can only tell an
+    out-of-range top lane; the callers bound their results up front.
+
+    Examples:
+        >>> check_lanes(127, 1)
+        >>> check_lanes(128, 1)
+        Traceback (most recent call last):
+        ...
+        OverflowError: Lane value does not fit the lane width
+    """
+    if bound >= 1 << (8 * nbytes - 1):
+        raise OverflowError("Lane value does not fit the lane width")
+
+
+def unpack_lanes(packed: int, count: int, nbytes: int = 8) -> List[int]:
+    """The lanes of an integer built by `pack_lanes`"""
+    _, top, _ = _layout(count, nbytes)
+    biased = packed + top
+    if biased < 0 or biased >> (8 * nbytes * count):
+        raise OverflowError("Lane value does not fit the lane width")
+    return _from_bytes((biased ^ top).to_bytes(count * nbytes, "little"), nbytes)
+
+
+def rb_neg(a: RbVector) -> RbVector:
+    """Negate every lane by swapping the digit masks"""
+    return a._replace(pos=a.neg, neg=a.pos)
+
+
+def rb_add(a: RbVector, b: RbVector) -> RbVector:
+    """Lane-wise carry-free sum of two packed signed-digit vectors
+
+    Examples:
+        >>> s = rb_add(pack_values([28, -3], 1), pack_values([5, -60], 1))
+        >>> rb_values(s)
+        [33, -63]
+    """
+    if (a.nbytes, a.count) != (b.nbytes, b.count):
+        raise ValueError("Vectors have different layouts")
+    _, top, keep = _layout(a.count, a.nbytes)
+    xp, xn, yp, yn = a.pos, a.neg, b.pos, b.neg
+    # classify z = x + y: +2, -2, +1, -1 (anything else is zero)
+    p2, n2 = xp & yp, xn & yn
+    p1 = (xp ^ yp) & ~(xn | yn)
+    n1 = (xn ^ yn) & ~(xp | yp)
+    neg_low = ((n2 | n1) << 1) & keep
+    up_p = p2 | (p1 & ~neg_low)
+    up_n = n2 | (n1 & neg_low)
+    if (up_p | up_n) & top:
+        raise OverflowError("Transfer out of a lane: use more guard bits")
+    tp, tn = up_p << 1, up_n << 1
+    odd = p1 | n1
+    wp, wn = odd & neg_low, odd & ~neg_low
+    sp, sn = wp | tp, wn | tn
+    return a._replace(pos=sp & ~sn, neg=sn & ~sp)
+
+
+def rb_sub(a: RbVector, b: RbVector) -> RbVector:
+    """Lane-wise carry-free difference"""
+    return rb_add(a, rb_neg(b))
+
+
+def rb_sum(vectors: Sequence[RbVector]) -> RbVector:
+    """Sum by a balanced tree of carry-free adders
+
+    A tree over n operands is ceil(log2(n)) adders deep and needs as many
+    guard bits.
+
+    Examples:
+        >>> rb_values(rb_sum([pack_values([k, -k], 2) for k in range(1, 6)]))
+        [15, -15]
+    """
+    level = list(vectors)
+    if not level:
+        raise ValueError("Nothing to add")
+    while len(level) > 1:
+        pairs = [rb_add(a, b) for a, b in zip(level[::2], level[1::2])]
+        level = pairs + level[len(pairs) * 2 :]
+    return level[0]
+
+
+def to_twos_complement(a: RbVector) -> int:
+    """Lane-wise ``pos - neg`` in two's complement, in one subtraction
+
+    Hardware converts the redundant result on the fly, digit by digit from
+    the top. Here every lane first gets a bias of ``2**(lane_bits - 1)``,
+    which keeps all lane differences positive, so one big subtraction
+    cannot borrow across lanes; toggling the bias bit back gives the two's
+    complement of each lane.
+
+    Examples:
+        >>> hex(to_twos_complement(pack_values([28, -3], 1)))
+        '0xfd1c'
+    """
+    _, top, _ = _layout(a.count, a.nbytes)
+    if (a.pos | a.neg) & top:
+        raise OverflowError("Digit in the sign position of a lane")
+    return ((a.pos | top) - a.neg) ^ top
+
+
+def rb_values(a: RbVector) -> List[int]:
+    """Signed value of every lane
+
+    Examples:
+        >>> rb_values(pack_values([28, -3, 0], 1))
+        [28, -3, 0]
+    """
+    data = to_twos_complement(a).to_bytes(a.count * a.nbytes, "little")
+    return _from_bytes(data, a.nbytes)
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
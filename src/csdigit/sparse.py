@@ -0,0 +1,290 @@
+"""
+Sparse CSD Term Lists
+
+CSD numbers are mostly zeros, so a value is kept as the list of its
+non-zero terms ``(power, sign)``, most significant first, standing for
+``sum(sign * 2**power)``. Memory and most operations are O(nnz); only
+conversions from integers and canonicalization touch every bit, and they
+do it with string and big-integer operations in C.
+"""
+import re
+from fractions import Fraction
+from math import floor
+from typing import Dict, List, Sequence, Tuple, Union
+
+from csdigit.csd import to_csd
+from csdigit.mask import to_csd_mask
+
+Term = Tuple[int, int]  # (power, sign)
+
+_NONZERO = re.compile(r"[+-]")
+
+
+def to_sparse(csd: str) -> List[Term]:
+    """Terms of a string in the format of `to_csd`, skipping the zero runs
+
+    Examples:
+        >>> to_sparse("+00-00.+")
+        [(5, 1), (2, -1), (-1, 1)]
+    """
+    loc = csd.find(".")
+    if loc < 0:
+        loc = len(csd)
+    terms = []
+    for match in _NONZERO.finditer(csd):
+        pos = match.start()
+        power = loc - pos - 1 if pos < loc else loc - pos
+        terms.append((power, 1 if match.group() == "+" else -1))
+    return terms
+
+
+def _mask_terms(pos: int, neg: int, offset: int = 0) -> List[Term]:
+    both = pos | neg
+    if both == 0:
+        return []
+    width = both.bit_length()
+    bits = format(both, "b")
+    pbits = format(pos, "b").zfill(width)
+    terms = []
+    j = bits.find("1")
+    while j >= 0:
+        terms.append((width - 1 - j + offset, 1 if pbits[j] == "1" else -1))
+        j = bits.find("1", j + 1)
+    return terms
+
+
+def to_sparse_i(num: int) -> List[Term]:
+    """Terms of the CSD form of an integer, as given by `to_csd_i`
+
+    Examples:
+        >>> to_sparse_i(28)
+        [(5, 1), (2, -1)]
+    """
+    return _mask_terms(*to_csd_mask(num))
+
+
+def to_sparse_f(num: float, places: int) -> List[Term]:
+    """Terms of ``to_csd(num, places)`` without building the string
+
+    The greedy digits of `to_csd` at weight 2**i are the bits of
+    ``floor(1.5 * y)`` minus those of ``floor(y / 2)``, where
+    ``y = |num| * 2**places``, which is the non-adjacent-form bit trick
+    applied to a real number.
+
+    Examples:
+        >>> to_sparse_f(28.5, 2)
+        [(5, 1), (2, -1), (-1, 1)]
+        >>> to_sparse_f(-0.5, 2)
+        [(-1, -1)]
+    """
+    if num == 0.0:
+        return []
+    scaled = abs(Fraction(num)) * 2**places
+    three_half = floor(scaled * 3 / 2)
+    half = floor(scaled / 2)
+    diff = three_half ^ half
+    pos, neg = three_half & diff, half & diff
+    if num < 0:
+        pos, neg = neg, pos
+    if abs(num) < 1.0 and (pos | neg) >> places:
+        # `to_csd` has no integer digit for |num| < 1
+        return to_sparse(to_csd(num, places))
+    return _mask_terms(pos, neg, -places)
+
+
+def sparse_to_csd(terms: Sequence[Term]) -> str:
+    """String in the format of `to_csd`, with as many places as needed
+
+    Examples:
+        >>> sparse_to_csd([(5, 1), (2, -1), (-1, 1)])
+        '+00-00.+'
+        >>> sparse_to_csd([(-3, -1)])
+        '0.00-'
+    """
+    if not terms:
+        return "0"
+    top = max(terms[0][0], 0)
+    low = min(terms[-1][0], 0)
+    digits = ["0"] * (top - low + 1)
+    for power, sign in terms:
+        digits[top - power] = "+" if sign > 0 else "-"
+    csd = "".join(digits)
+    if low < 0:
+        csd = csd[: top + 1] + "." + csd[top + 1 :]
+    return csd
+
+
+def sparse_value(terms: Sequence[Term]) -> Union[int, Fraction]:
+    """Exact value of a term list
+
+    Examples:
+        >>> sparse_value([(5, 1), (2, -1)])
+        28
+        >>> sparse_value([(5, 1), (2, -1), (-1, 1)])
+        Fraction(57, 2)
+    """
+    if not terms:
+        return 0
+    low = min(min(power for power, _ in terms), 0)
+    value = _scaled_value(terms, low)
+    return value if low == 0 else Fraction(value, 1 << -low)
+
+
+def sparse_neg(terms: Sequence[Term]) -> List[Term]:
+    """Negate a term list
+
+    Examples:
+        >>> sparse_neg([(5, 1), (2, -1)])
+        [(5, -1), (2, 1)]
+    """
+    return [(power, -sign) for power, sign in terms]
+
+
+def sparse_shift(terms: Sequence[Term], k: int) -> List[Term]:
+    """Multiply a term list by 2**k
+
+    Examples:
+        >>> sparse_shift([(5, 1), (2, -1)], -3)
+        [(2, 1), (-1, -1)]
+    """
+    return [(power + k, sign) for power, sign in terms]
+
+
+def _to_masks(terms: Sequence[Term], low: int) -> Tuple[int, int]:
+    """Positive and negative bit masks, bit 0 at power `low`
+
+    The powers must be distinct. The bits are set in a bytearray, so the
+    cost is O(nnz) plus one conversion of the whole width."""
+    nbytes = (max(power for power, _ in terms) - low) // 8 + 1
+    pos = bytearray(nbytes)
+    neg = bytearray(nbytes)
+    for power, sign in terms:
+        bit = power - low
+        if sign > 0:
+            pos[bit >> 3] |= 1 << (bit & 7)
+        else:
+            neg[bit >> 3] |= 1 << (bit & 7)
+    return int.from_bytes(pos, "little"), int.from_bytes(neg, "little")
+
+
+def _scaled_value(terms: Sequence[Term], low: int) -> int:
+    """Value of the terms times 2**-low, for terms in any order"""
+    value = 0
+    remaining = sorted(terms, reverse=True)
+    # repeated powers do not fit in one mask: add them layer by layer
+    while remaining:
+        unique = []
+        rest = []
+        last = None
+        for term in remaining:
+            (rest if term[0] == last else unique).append(term)
+            last = term[0]
+        pos, neg = _to_masks(unique, low)
+        value += pos - neg
+        remaining = rest
+    return value
+
+
+def sparse_canonical(terms: Sequence[Term]) -> List[Term]:
+    """Canonical (CSD) term list of the same value
+
+    The terms may be unsorted, repeat powers or be adjacent.
+
+    Examples:
+        >>> sparse_canonical([(1, 1), (0, 1)])
+        [(2, 1), (0, -1)]
+        >>> sparse_canonical([(3, 1), (3, 1), (-1, 1)])
+        [(4, 1), (-1, 1)]
+    """
+    if not terms:
+        return []
+    low = min(power for power, _ in terms)
+    return _mask_terms(*to_csd_mask(_scaled_value(terms, low)), low)
+
+
+def sparse_add(a: Sequence[Term], b: Sequence[Term]) -> List[Term]:
+    """Sum of two canonical term lists, in canonical form
+
+    The two lists are merged in O(nnz). Only if the merged terms collide or
+    touch, which would break the non-adjacent form, is the result
+    canonicalized.
+
+    Examples:
+        >>> sparse_add([(5, 1)], [(2, -1)])
+        [(5, 1), (2, -1)]
+        >>> sparse_add([(2, 1)], [(2, 1)])
+        [(3, 1)]
+    """
+    merged = []
+    i = j = 0
+    while i < len(a) and j < len(b):
+        if a[i][0] >= b[j][0]:
+            merged.append(a[i])
+            i += 1
+        else:
+            merged.append(b[j])
+            j += 1
+    merged += a[i:]
+    merged += b[j:]
+    for upper, lower in zip(merged, merged[1:]):
+        if upper[0] - lower[0] < 2:
+            return sparse_canonical(merged)
+    return merged
+
+
+def sparse_mul(a: Sequence[Term], b: Sequence[Term]) -> List[Term]:
+    """Product of two term lists, in canonical form
+
+    The pairwise products are accumulated per power in O(nnz_a * nnz_b).
+    The accumulated coefficients are then split into their binary digits,
+    which gives O(log nnz) layers of distinct powers, each turned into one
+    mask before a single canonicalization.
+
+    Examples:
+        >>> sparse_mul([(5, 1), (2, -1)], [(0, 1), (-1, -1)])
+        [(4, 1), (1, -1)]
+    """
+    coeffs: Dict[int, int] = {}
+    for pa, sa in a:
+        for pb, sb in b:
+            power = pa + pb
+            coeffs[power] = coeffs.get(power, 0) + sa * sb
+    coeffs = {power: c for power, c in coeffs.items() if c}
+    if not coeffs:
+        return []
+    low = min(coeffs)
+    value = 0
+    layer = 0
+    while coeffs:
+        terms = [
+            (power, 1 if c > 0 else -1) for power, c in coeffs.items() if abs(c) & 1
+        ]
+        if terms:
+            pos, neg = _to_masks(terms, low)
+            value += (pos - neg) << layer
+        # halve the magnitudes, dropping the digit just used
+        coeffs = {
+            p: c >> 1 if c > 0 else -(-c >> 1)
+            for p, c in coeffs.items()
+            if abs(c) > 1
+        }
+        layer += 1
+    return _mask_terms(*to_csd_mask(value), low)
+
+
+def csd_multiply(csd_a: str, csd_b: str) -> str:
+    """Exact product of two CSD strings, as a canonical CSD string
+
+    Examples:
+        >>> csd_multiply("+00-00.+", "0.-")
+        '-00+0.0-'
+        >>> csd_multiply("+0-", "+0-")
+        '+00+'
+    """
+    return sparse_to_csd(sparse_mul(to_sparse(csd_a), to_sparse(csd_b)))
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
@@ -0,0 +1,171 @@
+"""
+Runtime-Specialized Callables for Fixed CSD Coefficients
+
+Instead of walking the digit string on every call, the shifts and adds of a
+coefficient are unrolled into Python source and turned into a function with
+``compile()``. The generated code uses only ``+``, ``-``, ``<<`` and ``*``,
+so it works element-wise on NumPy arrays as well as on scalars. Compiled
+functions are cached per digit string.
+"""
+from functools import lru_cache
+from time import perf_counter
+from typing import Callable, Iterable, List, Sequence, Tuple
+
+from csdigit.cse import extract_common_subexpressions
+
+
+def interpret_csd(csd: str, x):
+    """Multiply `x` by a CSD coefficient by walking its digits
+
+    Examples:
+        >>> interpret_csd("+00-00", 3)
+        84
+        >>> interpret_csd("+00-00.+", 2.0)
+        57.0
+    """
+    acc = 0
+    loc = 0
+    for pos, digit in enumerate(csd):
+        if digit == "0":
+            acc = acc * 2
+        elif digit == "+":
+            acc = acc * 2 + x
+        elif digit == "-":
+            acc = acc * 2 - x
+        elif digit == ".":
+            loc = pos + 1
+        else:
+            raise ValueError("Work with 0, +, -, . only")
+    if loc != 0:
+        acc = acc * 2.0 ** (loc - len(csd))
+    return acc
+
+
+def _places(csd: str) -> int:
+    loc = csd.find(".")
+    return 0 if loc < 0 else len(csd) - loc - 1
+
+
+def _int_value(csd: str) -> int:
+    """The digits as an integer, checked before any source is generated"""
+    if csd.count(".") > 1:
+        raise ValueError("More than one point in {!r}".format(csd))
+    num = 0
+    for digit in csd.replace(".", ""):
+        if digit not in "0+-":
+            raise ValueError("Work with 0, +, -, . only")
+        num = num * 2 + (digit == "+") - (digit == "-")
+    return num
+
+
+def _source(nums: Sequence[int], places: int, name: str, single: bool) -> str:
+    subexprs, terms = extract_common_subexpressions(nums)
+    fmt = "(t{} << {})" if places == 0 else "(t{} * {})"
+
+    def shifted(sym: int, shift: int) -> str:
+        if shift == 0:
+            return "t{}".format(sym)
+        return fmt.format(sym, shift if places == 0 else 2**shift)
+
+    lines = ["def {}(x):".format(name), "    t0 = x"]
+    for k, (hi, lo, dist, sign) in enumerate(subexprs, 1):
+        op = "+" if sign > 0 else "-"
+        lines.append("    t{} = {} {} t{}".format(k, shifted(hi, dist), op, lo))
+    outs = []
+    for t in terms:
+        expr = ""
+        for shift, sign, sym in t:
+            term = shifted(sym, shift)
+            if not expr:
+                expr = term if sign > 0 else "-" + term
+            else:
+                expr += " {} {}".format("+" if sign > 0 else "-", term)
+        expr = expr or "0 * t0"
+        if places:
+            expr = "({}) * {!r}".format(expr, 2.0**-places)
+        outs.append(expr)
+    if single:
+        lines.append("    return " + outs[0])
+    else:
+        lines.append("    return (" + ", ".join(outs) + ",)")
+    return "\n".join(lines) + "\n"
+
+
+def _build(source: str, name: str) -> Callable:
+    namespace: dict = {}
+    exec(compile(source, "<csd:{}>".format(name), "exec"), namespace)
+    func = namespace[name]
+    func.__source__ = source
+    return func
+
+
+@lru_cache(maxsize=1024)
+def compile_csd(csd: str) -> Callable:
+    """Specialized function computing ``x * to_decimal(csd)``
+
+    Integer coefficients use shifts, so the result is exact for integer
+    inputs. Fractional ones use power-of-two multipliers and a final scale,
+    which is exact for floating-point inputs.
+
+    Examples:
+        >>> f = compile_csd("+00-00")
+        >>> f(3)
+        84
+        >>> print(f.__source__, end="")
+        def csd_mul(x):
+            t0 = x
+            return (t0 << 5) - (t0 << 2)
+        >>> compile_csd("+00-00.+")(2.0)
+        57.0
+    """
+    source = _source([_int_value(csd)], _places(csd), "csd_mul", True)
+    return _build(source, "csd_mul")
+
+
+@lru_cache(maxsize=256)
+def compile_csd_set(csds: Tuple[str, ...]) -> Callable:
+    """Specialized function computing x times every coefficient of a set
+
+    The coefficients are aligned to a common number of fractional places and
+    share subexpressions through `extract_common_subexpressions`.
+
+    Examples:
+        >>> f = compile_csd_set(("+0+", "+0+0", "+0+0+"))
+        >>> f(3)
+        (15, 30, 63)
+        >>> compile_csd_set(("+.+", "0.-"))(4.0)
+        (6.0, -2.0)
+    """
+    places = max(_places(csd) for csd in csds)
+    nums = [_int_value(csd) << (places - _places(csd)) for csd in csds]
+    return _build(_source(nums, places, "csd_mul_set", False), "csd_mul_set")
+
+
+def benchmark(csd: str, values: Iterable, repeat: int = 3) -> Tuple[float, float]:
+    """Best-of-`repeat` seconds for interpreting and for the compiled function
+
+    Examples:
+        >>> t_interp, t_comp = benchmark("+00-00.+", [1.0] * 10, repeat=1)
+        >>> t_interp > 0 and t_comp > 0
+        True
+    """
+    values = list(values)
+    func = compile_csd(csd)
+
+    def best(run: Callable) -> float:
+        times: List[float] = []
+        for _ in range(repeat):
+            start = perf_counter()
+            run()
+            times.append(perf_counter() - start)
+        return min(times)
+
+    t_interp = best(lambda: [interpret_csd(csd, x) for x in values])
+    t_comp = best(lambda: [func(x) for x in values])
+    return t_interp, t_comp
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
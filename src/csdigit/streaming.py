@@ -0,0 +1,118 @@
+"""
+Left-to-Right (MSB-First) Signed-Digit Recoding
+
+The digit at a position may need to change because of bits arbitrarily far
+below it before the non-adjacent form is known, so CSD cannot be produced
+MSB first with bounded lookahead. A minimal-weight form can: the recoder is
+a two-state automaton reading unsigned bits MSB first,
+
+- state N (the digits so far equal the bits so far): a 1 gives ``+``; a 0
+  gives ``+`` and switches to C if the next two bits are 11, else ``0``;
+- state C (the digits so far exceed the bits so far by one unit of the
+  current position): a 0 gives ``-``; a 1 gives ``-`` and switches back to N
+  if the next two bits are 00, else ``0``.
+
+The output has the same number of non-zeros as the CSD form (checked
+exhaustively in the tests), and each digit is emitted two bits after its
+own bit arrives. An extra leading digit is emitted for the position above
+the most significant bit.
+"""
+from collections import deque
+from typing import Deque, Iterable, Iterator
+
+
+class MsbFirstRecoder:
+    """Incremental recoder: push bits MSB first, get digits with delay 2
+
+    Examples:
+        >>> rec = MsbFirstRecoder()
+        >>> "".join(rec.push(b) for b in (1, 1, 1)) + rec.flush()
+        '+00-'
+    """
+
+    delay = 2
+
+    def __init__(self):
+        self._carry = False  # state C
+        self._bits: Deque[int] = deque([0])  # the extra leading position
+
+    def _step(self) -> str:
+        bit, la1, la2 = self._bits[0], self._bits[1], self._bits[2]
+        self._bits.popleft()
+        if not self._carry:
+            if bit:
+                return "+"
+            if la1 and la2:
+                self._carry = True
+                return "+"
+            return "0"
+        if not bit:
+            return "-"
+        if not (la1 or la2):
+            self._carry = False
+            return "-"
+        return "0"
+
+    def push(self, bit: int) -> str:
+        """Feed the next bit; returns the digit it completes, if any"""
+        self._bits.append(1 if bit else 0)
+        return self._step() if len(self._bits) > self.delay else ""
+
+    def flush(self) -> str:
+        """End of input: emit the remaining digits and reset"""
+        pending = len(self._bits)
+        self._bits.extend((0, 0))
+        digits = "".join(self._step() for _ in range(pending))
+        self.__init__()
+        return digits
+
+
+def recode_msb_first(bits: Iterable[int]) -> Iterator[str]:
+    """Minimal-weight signed digits of an unsigned bit stream, MSB first
+
+    Examples:
+        >>> "".join(recode_msb_first([1, 0, 1, 1]))
+        '0++0-'
+    """
+    rec = MsbFirstRecoder()
+    for bit in bits:
+        digit = rec.push(bit)
+        if digit:
+            yield digit
+    yield from rec.flush()
+
+
+def recode_bytes(chunks: Iterable[bytes]) -> Iterator[str]:
+    """Like `recode_msb_first`, on big-endian bytes arriving in chunks
+
+    Examples:
+        >>> "".join(recode_bytes([b"\\x07"]))
+        '00000+00-'
+    """
+    return recode_msb_first(
+        (byte >> shift) & 1
+        for chunk in chunks
+        for byte in chunk
+        for shift in range(7, -1, -1)
+    )
+
+
+def to_csd_msb(num: int) -> str:
+    """Recode a non-negative integer MSB first, without leading zeros
+
+    Examples:
+        >>> to_csd_msb(28)
+        '+00-00'
+    """
+    if num <= 0:
+        if num == 0:
+            return "0"
+        raise ValueError("Expects a non-negative integer")
+    digits = "".join(recode_msb_first(int(b) for b in format(num, "b")))
+    return digits.lstrip("0")
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
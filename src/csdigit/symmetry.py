@@ -0,0 +1,182 @@
+"""
+Linear-Phase Symmetry
+
+The taps of a linear-phase FIR filter satisfy ``h[n - 1 - k] == h[k]``
+(symmetric) or ``h[n - 1 - k] == -h[k]`` (antisymmetric). Since `to_csd`
+and `to_csdfixed` commute with negation, only the first ``(n + 1) // 2``
+taps need to be converted, costed or searched for subexpressions; the rest
+is mirrored, with ``+`` and ``-`` swapped in the antisymmetric case. A
+folded filter structure also needs only one multiplier per pair of taps,
+after a pre-adder that forms ``x[n - k] +/- x[n - N + 1 + k]``.
+"""
+from operator import neg
+from typing import Callable, List, NamedTuple, Sequence, Tuple, TypeVar
+
+from csdigit.csd import to_csd, to_csdfixed, to_decimal
+from csdigit.cse import Pattern, Term, adder_count, extract_common_subexpressions
+
+T = TypeVar("T")
+
+_SWAP = str.maketrans("+-", "-+")
+
+
+def symmetry(coeffs: Sequence[float], tol: float = 0.0) -> int:
+    """1 for symmetric, -1 for antisymmetric and 0 for neither
+
+    Examples:
+        >>> symmetry([0.1, 0.5, 0.1]), symmetry([0.1, 0.0, -0.1])
+        (1, -1)
+        >>> symmetry([0.1, 0.5])
+        0
+    """
+    pairs = list(zip(coeffs, reversed(coeffs)))
+    if all(abs(a - b) <= tol for a, b in pairs):
+        return 1
+    if all(abs(a + b) <= tol for a, b in pairs):
+        return -1
+    return 0
+
+
+def fold(coeffs: Sequence[T], sym: int) -> List[T]:
+    """The taps that determine the vector: the first half, with the center"""
+    return list(coeffs[: (len(coeffs) + 1) // 2] if sym else coeffs)
+
+
+def unfold(
+    half: Sequence[T], length: int, sym: int, negate: Callable[[T], T] = neg
+) -> List[T]:
+    """Mirror the result of `fold` (or of a map over it) back to `length`
+
+    Examples:
+        >>> unfold([1, 2, 3], 5, -1)
+        [1, 2, 3, -2, -1]
+    """
+    if not sym:
+        return list(half)
+    mirrored = list(reversed(half[: length // 2]))
+    if sym < 0:
+        mirrored = [negate(v) for v in mirrored]
+    return list(half) + mirrored
+
+
+def negate_csd(csd: str) -> str:
+    """Negate a CSD string by swapping its signs
+
+    Examples:
+        >>> negate_csd("+00-00.+")
+        '-00+00.-'
+    """
+    return csd.translate(_SWAP)
+
+
+def map_symmetric(
+    func: Callable, coeffs: Sequence[float], negate: Callable = neg, tol: float = 0.0
+) -> List:
+    """``[func(c) for c in coeffs]`` computed on the folded taps only
+
+    `func` must commute with negation, ``func(-c) == negate(func(c))``, for
+    antisymmetric vectors. Within `tol`, the vector is treated as exactly
+    (anti)symmetric.
+    """
+    sym = symmetry(coeffs, tol)
+    return unfold([func(c) for c in fold(coeffs, sym)], len(coeffs), sym, negate)
+
+
+def to_csd_symmetric(coeffs: Sequence[float], places: int) -> List[str]:
+    """`to_csd` of every tap, converting half of a linear-phase vector
+
+    Examples:
+        >>> to_csd_symmetric([0.25, -0.5, 0.0, 0.5, -0.25], 2)
+        ['0.0+', '0.-0', '0', '0.+0', '0.0-']
+    """
+    return map_symmetric(lambda c: to_csd(c, places), coeffs, negate_csd)
+
+
+def to_csdfixed_symmetric(coeffs: Sequence[float], nnz: int) -> List[str]:
+    """`to_csdfixed` of every tap, converting half of a linear-phase vector
+
+    Examples:
+        >>> to_csdfixed_symmetric([0.3, 0.7, 0.3], 2)
+        ['0.0+0+', '0.++', '0.0+0+']
+    """
+    return map_symmetric(lambda c: to_csdfixed(c, nnz), coeffs, negate_csd)
+
+
+def to_csd_symmetric_batch(
+    vectors: Sequence[Sequence[float]], places: int
+) -> List[List[str]]:
+    """Apply `to_csd_symmetric` to every vector"""
+    return [to_csd_symmetric(coeffs, places) for coeffs in vectors]
+
+
+class SymmetricCost(NamedTuple):
+    """Hardware cost of a CSD coefficient vector"""
+
+    symmetry: int
+    nnz: int  # non-zero digits over all taps
+    multiplier_adders: int  # in the multipliers of a folded structure
+    pre_adders: int  # pairing mirrored samples
+
+
+def _nnz(csd: str) -> int:
+    return csd.count("+") + csd.count("-")
+
+
+def symmetric_cost(coeffs: Sequence[float], places: int) -> SymmetricCost:
+    """Cost of `to_csd` coefficients, computed on the folded taps
+
+    Examples:
+        >>> symmetric_cost([0.75, 0.375, 0.75], 3)
+        SymmetricCost(symmetry=1, nnz=6, multiplier_adders=2, pre_adders=1)
+    """
+    sym = symmetry(coeffs)
+    half = [_nnz(to_csd(c, places)) for c in fold(coeffs, sym)]
+    full = unfold(half, len(coeffs), sym, lambda n: n)
+    return SymmetricCost(
+        sym,
+        sum(full),
+        sum(max(n - 1, 0) for n in half),
+        len(coeffs) // 2 if sym else 0,
+    )
+
+
+def cse_symmetric(
+    coeffs: Sequence[float], places: int
+) -> Tuple[List[Pattern], List[List[Term]], int]:
+    """Common subexpressions of the folded taps, mirrored to all taps
+
+    The coefficients are quantized by `to_csd` and scaled by 2**places to
+    integers.
+
+    Returns:
+        Tuple[List[Pattern], List[List[Term]], int]: the subexpressions and
+            the terms of every tap, as in `extract_common_subexpressions`,
+            and the adders of the folded structure (pre-adders included)
+
+    Examples:
+        >>> coeffs = [0.625, 1.25, 0.0, -1.25, -0.625]
+        >>> subexprs, terms, adders = cse_symmetric(coeffs, 3)
+        >>> subexprs, adders
+        ([(0, 0, 2, 1)], 3)
+        >>> terms[4]
+        [(0, -1, 1)]
+    """
+    sym = symmetry(coeffs)
+    ints = [
+        round(to_decimal(to_csd(c, places)) * 2**places) for c in fold(coeffs, sym)
+    ]
+    subexprs, half_terms = extract_common_subexpressions(ints)
+    terms = unfold(
+        half_terms,
+        len(coeffs),
+        sym,
+        lambda t: [(shift, -sign, symbol) for shift, sign, symbol in t],
+    )
+    adders = adder_count(subexprs, half_terms) + (len(coeffs) // 2 if sym else 0)
+    return subexprs, terms, adders
+
+
+if __name__ == "__main__":
+    import doctest
+
+    doctest.testmod()
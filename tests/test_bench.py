@@ -1,4 +1,11 @@
+import os
+
+import pytest
+
 from csdigit import csd
+from csdigit.perf_fuzz import TARGETS, load_corpus
+from csdigit.rb_adder import pack_values, rb_add, rb_values
+from csdigit.specialize import compile_csd, interpret_csd
 from pycsd import csd_orig
 
 
@@ -20,3 +27,42 @@ def test_csd(benchmark):
 
 def test_csd_orig(benchmark):
     benchmark(run_csd_orig)
+
+
+def run_interpret_csd():
+    coeff = csd.to_csd(0.7071067811865476, 20)
+    for x in range(100):
+        interpret_csd(coeff, float(x))
+
+
+def run_compile_csd():
+    func = compile_csd(csd.to_csd(0.7071067811865476, 20))
+    for x in range(100):
+        func(float(x))
+
+
+def test_interpret_csd(benchmark):
+    benchmark(run_interpret_csd)
+
+
+def test_compile_csd(benchmark):
+    benchmark(run_compile_csd)
+
+
+def run_rb_add():
+    xs = list(range(-50000, 50000))
+    assert rb_values(rb_add(pack_values(xs), pack_values(xs))) == [2 * x for x in xs]
+
+
+def test_rb_add(benchmark):
+    benchmark(run_rb_add)
+
+
+CORPUS = load_corpus(os.path.join(os.path.dirname(__file__), "perf_corpus.json"))
+
+
+@pytest.mark.parametrize(
+    "case", CORPUS, ids=["{}-{}".format(c.name, i) for i, c in enumerate(CORPUS)]
+)
+def test_slow_case(benchmark, case):
+    benchmark(TARGETS[case.name][0], *case.args)
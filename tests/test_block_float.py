@@ -0,0 +1,47 @@
+from math import ldexp
+
+from hypothesis import given
+from hypothesis.strategies import floats, integers, lists
+
+from csdigit.block_float import (
+    block_dot,
+    block_mantissas,
+    block_report,
+    decode_blocks,
+    encode_blocks,
+)
+from csdigit.csd import to_csd_i
+
+coefficients = lists(floats(-100.0, 100.0), min_size=1, max_size=40)
+
+
+@given(coefficients, integers(1, 9), integers(1, 20))
+def test_encode_decode(coeffs, block_size, width):
+    blocks = encode_blocks(coeffs, block_size, width)
+    values = decode_blocks(blocks)
+    assert len(values) == len(coeffs)
+    for k, block in enumerate(blocks):
+        chunk = coeffs[k * block_size : (k + 1) * block_size]
+        for c, v, csd in zip(chunk, values[k * block_size :], block_mantissas(block)):
+            # rounded to the nearest step of the block, in `width` digits
+            assert abs(v - c) <= ldexp(0.5, block.exponent)
+            assert len(csd) == width
+            mantissa = round(ldexp(v, -block.exponent))
+            assert csd.lstrip("0") == (to_csd_i(mantissa) if mantissa else "")
+
+
+@given(coefficients, lists(integers(-1000, 1000), min_size=40, max_size=40))
+def test_block_dot(coeffs, xs):
+    blocks = encode_blocks(coeffs, 8, 10)
+    values = decode_blocks(blocks)
+    expected = sum(v * x for v, x in zip(values, xs))
+    assert abs(block_dot(blocks, xs[: len(coeffs)]) - expected) <= 1e-9 * (
+        1 + abs(expected)
+    )
+
+
+def test_block_report():
+    coeffs = [0.9 * 0.5**k for k in range(32)]
+    report = block_report(coeffs, encode_blocks(coeffs, 8, 8), 16)
+    assert report.bits < report.csd_bits
+    assert report.max_error <= 2**-8
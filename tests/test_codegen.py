@@ -0,0 +1,30 @@
+import shutil
+
+import pytest
+
+from csdigit.codegen import compile_and_bench, emit_c
+
+
+def test_emit_c_array():
+    source = emit_c([5, 10, 21], name="f", array=True)
+    assert "void f(const int32_t *restrict x, int32_t *restrict y, size_t n)" in source
+    assert "y[2 * n + i]" in source
+
+
+def test_emit_c_width():
+    assert "(t0 << 31)" in emit_c([-(1 << 31), (1 << 31) - 1])
+    assert "(t0 << 15)" in emit_c([1 << 15], ctype="int64_t", utype="uint64_t")
+    for constants, ctype, utype in [
+        ([1 << 31], "int32_t", "uint32_t"),
+        ([-(1 << 15) - 1], "int16_t", "uint16_t"),
+        ([5], "int", "unsigned"),
+        ([5], "int32_t", "uint16_t"),
+    ]:
+        with pytest.raises(ValueError):
+            emit_c(constants, ctype=ctype, utype=utype)
+
+
+@pytest.mark.skipif(shutil.which("cc") is None, reason="no C compiler")
+def test_compile_and_bench():
+    res = compile_and_bench([5, -10, 21, 0, 12345], n=1024, repeat=2)
+    assert res["ok"] == 1.0
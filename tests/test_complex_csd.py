@@ -0,0 +1,45 @@
+import pytest
+from hypothesis import given
+from hypothesis.strategies import booleans, complex_numbers, integers, lists, tuples
+
+from csdigit.complex_csd import (
+    evaluate_complex,
+    plan_complex,
+    quantize_complex,
+    to_csd_complex,
+)
+from csdigit.csd import to_csd
+
+taps = lists(complex_numbers(max_magnitude=4.0), min_size=1, max_size=10)
+pairs = lists(tuples(integers(-(2**20), 2**20), integers(-(2**20), 2**20)))
+
+
+@given(taps)
+def test_to_csd_complex(values):
+    expected = [(to_csd(v.real, 6), to_csd(v.imag, 6)) for v in values]
+    assert to_csd_complex(values, 6) == expected
+
+
+@given(taps, pairs, booleans())
+def test_evaluate_complex(values, samples, gauss):
+    coeffs = quantize_complex(values, 8)
+    plan = plan_complex(coeffs, gauss)
+    assert plan.gauss == gauss
+    expected = [
+        [(a * xr - b * xi, a * xi + b * xr) for xr, xi in samples] for a, b in coeffs
+    ]
+    assert evaluate_complex(plan, samples) == expected
+
+
+@given(taps)
+def test_plan_complex(values):
+    coeffs = quantize_complex(values, 8)
+    costs = [plan_complex(coeffs, gauss).adders for gauss in (False, True)]
+    assert plan_complex(coeffs).adders == min(costs)
+
+
+def test_evaluate_complex_overflow():
+    plan = plan_complex([(3, 1), (0, -2)])
+    assert evaluate_complex(plan, [(31, 0), (0, 0)], 1)[0] == [(93, 31), (0, 0)]
+    with pytest.raises(OverflowError):
+        evaluate_complex(plan, [(100, 0), (0, 0)], 1)
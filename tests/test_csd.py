@@ -2,7 +2,7 @@ from hypothesis import given
 from hypothesis.strategies import integers
 
 from csdigit.csd import to_csd, to_csd_i, to_decimal, to_decimal_i
-from csdigit.csd import to_csdfixed
+from csdigit.csd import to_csdfixed, to_csdfixed_pareto, to_csdfixed_pareto_batch
 
 
 def test_csd_s():
@@ -24,3 +24,19 @@ def test_csd(number):
 def test_to_csdfixed():
     assert to_csdfixed(28.5, 4) == "+00-00.+"
     assert to_csdfixed(-0.5, 4) == "0.-"
+
+
+@given(integers(min_value=-(2**20), max_value=2**20), integers(0, 12))
+def test_to_csdfixed_pareto(number, shift):
+    fnum = number / 2**shift
+    front = to_csdfixed_pareto(fnum, 6)
+    for nnz, (csd, value, error) in enumerate(front, 1):
+        assert csd == to_csdfixed(fnum, nnz)
+        assert value == to_decimal(csd)
+        assert error == fnum - value
+
+
+def test_to_csdfixed_pareto_batch():
+    fronts = to_csdfixed_pareto_batch([28.5, 0.0], 3)
+    assert fronts[0] == to_csdfixed_pareto(28.5, 3)
+    assert [csd for csd, _, _ in fronts[1]] == ["0", "0", "0"]
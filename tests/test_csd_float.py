@@ -0,0 +1,68 @@
+from fractions import Fraction
+
+import pytest
+from hypothesis import given
+from hypothesis.strategies import floats, integers
+
+from csdigit.csd import to_csd_i, to_decimal
+from csdigit.csd_float import CsdFloat
+
+finite = floats(allow_nan=False, allow_infinity=False)
+
+
+@given(finite)
+def test_from_float(num):
+    value = CsdFloat.from_float(num)
+    assert float(value) == num
+    assert value.to_fraction() == Fraction(num)
+    assert CsdFloat.from_csd(value.to_csd()) == value
+
+
+@given(integers(-(2**30), 2**30), integers(0, 20))
+def test_to_csd(number, places):
+    fnum = number / 2**places
+    value = CsdFloat.from_float(fnum)
+    assert to_decimal(value.to_csd()) == fnum
+    # to_csd has no integer digit for |fnum| < 1, so compare with the integer
+    csd = to_csd_i(number) if number else "0"
+    assert value.nnz == csd.count("+") + csd.count("-")
+
+
+@given(finite, finite)
+def test_arithmetic(a, b):
+    x, y = CsdFloat.from_float(a), CsdFloat.from_float(b)
+    fa, fb = Fraction(a), Fraction(b)
+    assert (x + y).to_fraction() == fa + fb
+    assert (x - y).to_fraction() == fa - fb
+    assert (x * y).to_fraction() == fa * fb
+
+
+def test_mixed_types():
+    x = CsdFloat.from_float(1.5)
+    for other in (2, 2.0, Fraction(1, 2), "+0"):
+        for op in (lambda a, b: a + b, lambda a, b: a - b, lambda a, b: a * b):
+            with pytest.raises(TypeError):
+                op(x, other)
+            with pytest.raises(TypeError):
+                op(other, x)
+    assert x != 1.5
+
+
+def test_tiny():
+    value = CsdFloat.from_float(1e-30)
+    assert len(value.mantissa) <= 54
+    assert float(CsdFloat.from_csd(value.to_csd())) == 1e-30
+
+
+def test_from_fraction():
+    value = CsdFloat.from_fraction(Fraction(1, 3), digits=20)
+    assert abs(value.to_fraction() - Fraction(1, 3)) <= Fraction(1, 2**21)
+
+
+def test_float_of_long_product():
+    x = CsdFloat.from_float(1.1)
+    value = x
+    for _ in range(25):
+        value = value * x
+    assert value.to_fraction().numerator.bit_length() > 1100
+    assert float(value) == float(Fraction(1.1) ** 26)
@@ -0,0 +1,20 @@
+from csdigit.csd import to_csd_i
+from csdigit.csd_range import csd_mask_range, csd_range
+from csdigit.mask import to_csd_mask
+
+
+def test_csd_range():
+    for num, csd in zip(range(-3000, 3000), csd_range(-3000, 3000)):
+        assert csd == (to_csd_i(num) if num else "0")
+
+
+def test_csd_range_carry():
+    start = 2**64 - 100
+    assert list(csd_range(start, start + 200)) == [
+        to_csd_i(num) for num in range(start, start + 200)
+    ]
+
+
+def test_csd_mask_range():
+    masks = list(csd_mask_range(-500, 500))
+    assert masks == [to_csd_mask(num) for num in range(-500, 500)]
@@ -0,0 +1,86 @@
+from collections import Counter
+
+from hypothesis import given
+from hypothesis.strategies import integers, lists
+
+from csdigit.cse import (
+    PatternHistogram,
+    adder_count,
+    csd_terms,
+    evaluate_cse,
+    extract_common_subexpressions,
+    mcm_block,
+)
+
+
+@given(lists(integers(-(2**20), 2**20), min_size=1, max_size=8), integers())
+def test_extract_common_subexpressions(constants, x):
+    subexprs, terms = extract_common_subexpressions(constants)
+    assert evaluate_cse(subexprs, terms, x) == [c * x for c in constants]
+    plain = sum(max(len(csd_terms(c)) - 1, 0) for c in constants)
+    assert adder_count(subexprs, terms) <= plain
+
+
+@given(lists(integers(-(2**20), 2**20), max_size=8), integers())
+def test_mcm_block(constants, x):
+    block = mcm_block(constants)
+    products = block.products(x)
+    assert all(c * x == (products[c] if c >= 0 else -products[-c]) for c in constants)
+    plain = sum(max(len(csd_terms(c)) - 1, 0) for c in block.constants)
+    assert block.adders() <= plain
+
+
+def test_csd_terms():
+    assert csd_terms(0) == []
+    assert csd_terms(-3) == [(2, -1, 0), (0, 1, 0)]
+
+
+def _digits(pos, neg):
+    digits = [(i, 1) for i in range(pos.bit_length()) if pos >> i & 1]
+    digits += [(i, -1) for i in range(neg.bit_length()) if neg >> i & 1]
+    return sorted(digits)
+
+
+def _without(digits, pattern):
+    """The digits left by removing the non-overlapping occurrences of a
+    pattern, upper ones first"""
+    _, _, dist, sign = pattern
+    left = sorted(digits, reverse=True)
+    used = set()
+    for i, (hi, g_hi) in enumerate(left):
+        if i in used:
+            continue
+        for j in range(i + 1, len(left)):
+            lo, g_lo = left[j]
+            if j not in used and hi - lo == dist and g_hi * g_lo == sign:
+                used.update((i, j))
+                break
+    return sorted(d for k, d in enumerate(left) if k not in used)
+
+
+@given(lists(integers(-(2**20), 2**20), min_size=1, max_size=30))
+def test_pattern_histogram(constants):
+    hist = PatternHistogram(constants)
+    expected = Counter()
+    for c in constants:
+        terms = csd_terms(c)
+        for i, (s_hi, g_hi, _) in enumerate(terms):
+            for s_lo, g_lo, _ in terms[i + 1 :]:
+                expected[0, 0, s_hi - s_lo, g_hi * g_lo] += 1
+    assert hist.patterns() == expected
+    masks = hist.masks()
+    assert [_digits(pos, neg) for pos, neg in masks] == [
+        sorted((shift, sign) for shift, sign, _ in csd_terms(c)) for c in constants
+    ]
+    while hist.counts:
+        pattern, _ = max(hist.patterns().items(), key=lambda kv: (kv[1], -kv[0][2]))
+        found = hist.extract(pattern)
+        left = hist.masks()
+        expected = [_without(_digits(*m), pattern) for m in masks]
+        assert [_digits(*m) for m in left] == expected
+        before = sum(len(_digits(*m)) for m in masks)
+        assert before - sum(map(len, expected)) == 2 * found
+        masks = left
+        # the incremental counts agree with counting from scratch
+        fresh = PatternHistogram([pos - neg for pos, neg in masks])
+        assert hist.counts == fresh.counts
@@ -0,0 +1,56 @@
+from hypothesis import given
+from hypothesis.strategies import integers, lists
+
+from csdigit.cse import csd_terms
+from csdigit.dbns import (
+    dbns_cost,
+    dbns_value,
+    to_dbns,
+    to_dbns_batch,
+    to_dbns_search,
+)
+
+
+@given(integers(-(1 << 40), 1 << 40), integers(0, 4))
+def test_to_dbns(num, max_b):
+    terms = to_dbns(num, max_b)
+    assert dbns_value(terms) == num
+    assert all(b <= max_b and sign in (1, -1) for _, b, sign in terms)
+
+
+def test_to_dbns_powers_of_two():
+    # with b = 0, the nearest power of two is the CSD recoding
+    for num in range(-500, 500):
+        assert len(to_dbns(num, 0)) == len(csd_terms(num))
+
+
+@given(integers(-(1 << 20), 1 << 20))
+def test_to_dbns_search(num):
+    terms = to_dbns_search(num, 3, 2000)
+    assert dbns_value(terms) == num
+    assert len(terms) <= min(len(to_dbns(num)), len(csd_terms(num)))
+
+
+def test_to_dbns_search_minimal():
+    # the search finds the two terms of every such sum or difference
+    values = {
+        (3**b1 << a1) + s * (3**b2 << a2)
+        for a1 in range(6)
+        for a2 in range(6)
+        for b1 in range(3)
+        for b2 in range(3)
+        for s in (1, -1)
+    }
+    for num in values:
+        if num > 0:
+            assert len(to_dbns_search(num, 2)) <= 2
+
+
+@given(lists(integers(-5000, 5000), max_size=20))
+def test_to_dbns_batch(nums):
+    cache = {}
+    recodings = to_dbns_batch(nums, 3, True, cache)
+    assert [dbns_value(t) for t in recodings] == nums
+    assert recodings == to_dbns_batch(nums, 3, True, cache)
+    cost = dbns_cost(recodings)
+    assert cost.terms <= cost.csd_terms
@@ -0,0 +1,101 @@
+import json
+from math import ldexp
+
+import pytest
+from hypothesis import given
+from hypothesis.strategies import floats, integers, sampled_from, text
+
+from csdigit import csd, dispatch, lcsre
+
+
+def forced(name, backend, *args):
+    dispatch.set_backend(name, backend)
+    try:
+        return getattr(dispatch, name)(*args)
+    finally:
+        dispatch.set_backend(name, None)
+
+
+@given(floats(-1e6, 1e6), integers(0, 80))
+def test_to_csd(num, places):
+    expected = csd.to_csd(num, places)
+    assert forced("to_csd", "mask", num, places) == expected
+    assert forced("to_csd", "loop", num, places) == expected
+
+
+@given(integers(-8, 8), integers(-60, 60), sampled_from([1, -1]), integers(0, 100))
+def test_to_csd_near_two_thirds(offset, exponent, sign, places):
+    # 1.5 * num rounds onto a power of two in the loop
+    num = sign * ldexp((2**53 + 1) // 3 + offset, exponent - 52)
+    assert forced("to_csd", "mask", num, places) == csd.to_csd(num, places)
+
+
+def test_to_csd_long():
+    for places in (0, 1, 53, 200, 1100):
+        for num in (1 / 3, -2 / 3, 0.1, 1.0, -0.75, 123456.789):
+            assert forced("to_csd", "mask", num, places) == csd.to_csd(num, places)
+
+
+@given(integers(-(2**300), 2**300))
+def test_to_csd_i(num):
+    assert forced("to_csd_i", "mask", num) == csd.to_csd_i(num)
+
+
+@given(text(alphabet="+-0", max_size=80), integers(0, 80))
+def test_to_decimal(digits, places):
+    if places <= len(digits):
+        digits = digits[: len(digits) - places] + "." + digits[len(digits) - places :]
+    assert forced("to_decimal", "mask", digits) == csd.to_decimal(digits)
+
+
+def test_to_decimal_invalid():
+    with pytest.raises(ValueError):
+        forced("to_decimal", "mask", "+0x")
+
+
+@given(text(alphabet="+-0", max_size=60))
+def test_longest_repeated_substring(csd_str):
+    expected = lcsre.longest_repeated_substring(csd_str)
+    assert forced("longest_repeated_substring", "hash", csd_str) == expected
+
+
+def test_calibrate(tmp_path, monkeypatch):
+    path = tmp_path / "dispatch.json"
+    monkeypatch.setenv("CSDIGIT_DISPATCH_CONFIG", str(path))
+    result = dispatch.calibrate(save=True)
+    assert json.loads(path.read_text())["thresholds"] == result
+    assert dispatch.load_config()
+    assert dispatch.thresholds() == result
+    assert not dispatch.load_config(str(tmp_path / "missing.json"))
+
+
+def test_no_implicit_config(tmp_path, monkeypatch):
+    path = tmp_path / "dispatch.json"
+    monkeypatch.setenv("CSDIGIT_DISPATCH_CONFIG", str(path))
+    assert dispatch.to_csd_i(2**40) == csd.to_csd_i(2**40)
+    result = dispatch.calibrate()
+    assert not path.exists() and dispatch.thresholds() == result
+
+
+def test_counters_and_overrides(tmp_path, monkeypatch):
+    path = tmp_path / "dispatch.json"
+    path.write_text(json.dumps({"version": 1, "thresholds": {"to_csd_i": 16}}))
+    monkeypatch.setenv("CSDIGIT_DISPATCH_CONFIG", str(path))
+    assert dispatch.load_config()
+    dispatch.reset_counters()
+    dispatch.to_csd_i(5)
+    dispatch.to_csd_i(2**40)
+    dispatch.to_decimal("+0-")
+    assert dispatch.counters() == {
+        ("to_csd_i", "loop"): 1,
+        ("to_csd_i", "mask"): 1,
+        ("to_decimal", "loop"): 1,
+    }
+    dispatch.set_backend("to_csd_i", "mask")
+    dispatch.to_csd_i(5)
+    dispatch.set_backend("to_csd_i", None)
+    assert dispatch.counters()[("to_csd_i", "mask")] == 2
+    with pytest.raises(ValueError):
+        dispatch.set_backend("to_csd_i", "table")
+    with pytest.raises(KeyError):
+        dispatch.set_backend("to_bits", "mask")
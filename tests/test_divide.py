@@ -0,0 +1,25 @@
+from hypothesis import given
+from hypothesis.strategies import integers
+
+from csdigit.divide import division_plan, evaluate_plan, format_plan, verify_plan
+
+
+def test_division_plan_exhaustive():
+    for divisor in range(1, 40):
+        for rounding in ("floor", "round"):
+            plan = division_plan(divisor, 10, rounding)
+            assert verify_plan(plan) == "exhaustive"
+            assert plan.csd_adders <= plan.binary_adders
+
+
+@given(integers(1, 10**6), integers(0, 2**32 - 1))
+def test_division_plan_bound(divisor, x):
+    plan = division_plan(divisor, 32)
+    assert verify_plan(plan) == "bound"
+    assert evaluate_plan(plan, x) == x // divisor
+
+
+def test_division_plan_round():
+    plan = division_plan(10, 8, "round")
+    assert [evaluate_plan(plan, x) for x in (14, 15, 16)] == [1, 2, 2]
+    assert format_plan(plan).splitlines()[0] == "y = x + 5"
@@ -0,0 +1,60 @@
+from cmath import cos, exp
+
+import pytest
+from hypothesis import given
+from hypothesis.strategies import floats, lists, tuples
+
+from csdigit.csd import to_csd, to_decimal
+from csdigit.iir import in_triangle, poles, quantize_sos_batch
+
+coeff = floats(-2.0, 2.0)
+# stable sections by their pole radius and angle
+sections = lists(
+    tuples(coeff, coeff, coeff, floats(0.1, 0.999), floats(0.0, 3.14)), max_size=20
+).map(
+    lambda rows: [
+        (b0, b1, b2, 1.0, -2.0 * r * cos(theta).real, r * r)
+        for b0, b1, b2, r, theta in rows
+    ]
+)
+
+
+@given(coeff, floats(-1.5, 1.5))
+def test_poles(a1, a2):
+    for p in poles(a1, a2):
+        assert abs(p * p + a1 * p + a2) <= 1e-9
+    radius = max(map(abs, poles(a1, a2)))
+    if abs(radius - 1.0) > 1e-9:
+        assert in_triangle(a1, a2) == (radius < 1.0)
+
+
+def test_poles_of_radius():
+    r, theta = 0.9, 0.7
+    p, q = poles(-2.0 * r * cos(theta).real, r * r)
+    assert abs(p - r * exp(1j * theta)) <= 1e-12
+
+
+@given(sections)
+def test_quantize_sos_batch(rows):
+    results = quantize_sos_batch(rows, places=8, margin=0.001)
+    for row, result in zip(rows, results):
+        assert result.radius < 0.999
+        assert result.values == tuple(map(to_decimal, result.csds))
+        nearest = [to_csd(c, 8) for c in row[:3] + row[4:]]
+        assert list(result.csds[:3]) == nearest[:3]
+        if not result.adjusted:
+            assert list(result.csds) == nearest
+
+
+@given(sections)
+def test_quantize_sos_batch_nnz(rows):
+    for result in quantize_sos_batch(rows, nnz=4):
+        assert result.radius < 1.0
+        assert all(c.count("+") + c.count("-") <= 4 for c in result.csds)
+
+
+def test_arguments():
+    with pytest.raises(ValueError):
+        quantize_sos_batch([], places=4, nnz=2)
+    with pytest.raises(ValueError):
+        quantize_sos_batch([])
@@ -0,0 +1,99 @@
+from math import exp
+
+import pytest
+from hypothesis import given, settings
+from hypothesis.strategies import floats, integers, lists
+
+from csdigit.kernel2d import (
+    allocate_nnz,
+    convolve2d,
+    integer_kernel,
+    low_rank,
+    plan_kernel,
+)
+
+vectors = lists(floats(-4.0, 4.0), min_size=2, max_size=6)
+pixels = integers(-255, 255)
+
+
+def correlate(kernel, image):
+    height, width = len(kernel), len(kernel[0])
+    return [
+        [
+            sum(
+                kernel[r][c] * image[i + r][j + c]
+                for r in range(height)
+                for c in range(width)
+            )
+            for j in range(len(image[0]) - width + 1)
+        ]
+        for i in range(len(image) - height + 1)
+    ]
+
+
+@given(vectors, vectors, vectors, vectors)
+def test_low_rank(u1, v1, u2, v2):
+    size = min(len(u1), len(u2)), min(len(v1), len(v2))
+    kernel = [
+        [u1[i] * v1[j] + u2[i] * v2[j] for j in range(size[1])] for i in range(size[0])
+    ]
+    rebuilt = [[0.0] * size[1] for _ in range(size[0])]
+    for sigma, u, v in low_rank(kernel, 2, iterations=2000):
+        for i in range(size[0]):
+            for j in range(size[1]):
+                rebuilt[i][j] += sigma * u[i] * v[j]
+    peak = max([abs(x) for row in kernel for x in row] + [1.0])
+    for row, rrow in zip(kernel, rebuilt):
+        for x, y in zip(row, rrow):
+            assert abs(x - y) <= 1e-6 * peak
+
+
+@given(lists(floats(-2.0, 2.0), min_size=1, max_size=20), integers(0, 30))
+def test_allocate_nnz(values, budget):
+    csds = allocate_nnz(values, budget)
+    assert sum(c.count("+") + c.count("-") for c in csds) <= budget
+
+
+def gaussian(size, var):
+    half = size // 2
+    return [
+        [exp(-(i * i + j * j) / var) for j in range(-half, half + 1)]
+        for i in range(-half, half + 1)
+    ]
+
+
+@settings(max_examples=20, deadline=None)
+@given(
+    integers(0, 2),
+    integers(4, 40),
+    lists(lists(pixels, min_size=9, max_size=9), min_size=7, max_size=7),
+)
+def test_convolve2d(rank, budget, image):
+    kernel = gaussian(5, 3.0)
+    kernel[0][1] = -kernel[0][1]  # no longer separable
+    plan = plan_kernel(kernel, budget, rank)
+    assert plan.nnz <= budget
+    assert convolve2d(plan, image) == correlate(integer_kernel(plan), image)
+
+
+def test_separable_gaussian():
+    kernel = gaussian(7, 4.0)
+    direct = plan_kernel(kernel, 30)
+    separable = plan_kernel(kernel, 14, rank=1)
+    assert separable.max_error <= direct.max_error
+    assert separable.adders < direct.adders
+
+
+def test_zero_factors():
+    plan = plan_kernel([[1, 2], [2, 4]], 8, rank=2)
+    assert plan.rank == 1 and integer_kernel(plan) == [[1, 2], [2, 4]]
+    plan = plan_kernel([[0, 0], [0, 0]], 4, rank=1)
+    assert plan.rank == 0 and plan.adders == 0 and plan.max_error == 0.0
+    assert convolve2d(plan, [[1, 2, 3], [4, 5, 6]]) == [[0, 0]]
+
+
+def test_convolve2d_overflow():
+    plan = plan_kernel([[1, 2], [2, 4]], 4, rank=1)
+    assert convolve2d(plan, [[14, 14, 1], [14, 14, 1]], 1) == [[126, 48]]
+    with pytest.raises(OverflowError):
+        convolve2d(plan, [[100, 100, 1, 0], [100, 100, 1, 0]], 1)
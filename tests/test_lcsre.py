@@ -1,5 +1,50 @@
-from csdigit.lcsre import longest_repeated_substring
+from hypothesis import given
+from hypothesis.strategies import integers, text
+
+from csdigit.csd import to_csd_i
+from csdigit.lcsre import (
+    has_repeated_nonzeros,
+    longest_repeated_substring,
+    longest_repeated_substring_bounded,
+)
 
 
 def test_lcsre():
     assert longest_repeated_substring("+-00+-00+-00+-0") == "+-00+-0"
+
+
+def _nonzeros(s):
+    return len(s) - s.count("0")
+
+
+def _brute_has_repeat(csd_str, k):
+    n = len(csd_str)
+    for i in range(n):
+        for j in range(i + 1, n + 1):
+            sub = csd_str[i:j]
+            if _nonzeros(sub) >= k and csd_str.find(sub, j) >= 0:
+                return True
+    return False
+
+
+@given(text(alphabet="+-0", max_size=40))
+def test_lcsre_bounded(csd_str):
+    res = longest_repeated_substring(csd_str)
+    assert len(longest_repeated_substring_bounded(csd_str)) == len(res)
+    bounded = longest_repeated_substring_bounded(csd_str, 2, 5)
+    expect = min(len(res), 5) if len(res) >= 2 else 0
+    assert len(bounded) == expect
+    if bounded:
+        first = csd_str.find(bounded)
+        assert csd_str.find(bounded, first + len(bounded)) >= 0
+
+
+@given(text(alphabet="+-0", max_size=30), integers(min_value=1, max_value=6))
+def test_has_repeated_nonzeros(csd_str, k):
+    assert has_repeated_nonzeros(csd_str, k) == _brute_has_repeat(csd_str, k)
+
+
+def test_has_repeated_nonzeros_long():
+    csd_str = "0".join(to_csd_i(3**k) for k in range(100, 110))
+    assert has_repeated_nonzeros(csd_str, 3)
+    assert not has_repeated_nonzeros(csd_str, 3, max_len=4)
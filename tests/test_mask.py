@@ -0,0 +1,35 @@
+import io
+
+from hypothesis import given
+from hypothesis.strategies import integers
+
+from csdigit.csd import to_csd_i
+from csdigit.mask import (
+    csd_to_mask,
+    iter_csd_table,
+    mask_to_csd,
+    to_csd_mask,
+    to_decimal_mask,
+    write_csd_table,
+)
+
+
+@given(integers())
+def test_to_csd_mask(number):
+    pos, neg = to_csd_mask(number)
+    assert pos & neg == 0
+    assert pos & (pos >> 1) == 0 and neg & (neg >> 1) == 0
+    assert to_decimal_mask(pos, neg) == number
+    assert csd_to_mask(mask_to_csd(pos, neg)) == (pos, neg)
+
+
+@given(integers(min_value=1, max_value=2**60))
+def test_mask_to_csd(number):
+    assert mask_to_csd(*to_csd_mask(number)) == to_csd_i(number)
+
+
+def test_write_csd_table():
+    buf = io.BytesIO()
+    assert write_csd_table(buf, 1000, 3000, nbytes=2, chunk=256) == 2000 * 4
+    records = list(iter_csd_table(buf.getvalue(), 2))
+    assert records == [to_csd_mask(n) for n in range(1000, 3000)]
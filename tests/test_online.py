@@ -0,0 +1,70 @@
+from hypothesis import assume, given
+from hypothesis.strategies import integers, lists, sampled_from, text
+
+from csdigit.csd import to_csd
+from csdigit.online import (
+    OnlineAdder,
+    OnlineConstantMultiplier,
+    measure,
+    pack_streams,
+    simulate,
+    stream_value,
+    unpack_streams,
+)
+
+digits = text(alphabet="+-0", min_size=1, max_size=24)
+
+
+@given(lists(digits, min_size=1, max_size=8), lists(digits, min_size=1, max_size=8))
+def test_online_add(xs, ys):
+    count = min(len(xs), len(ys))
+    xs, ys = xs[:count], ys[:count]
+    for subtract in (False, True):
+        out = simulate(OnlineAdder(subtract), xs, ys)
+        width = max(len(s) for s in xs + ys)
+        for x, y, z in zip(xs, ys, out):
+            assert len(z) == width + 1
+            y_value = -stream_value(y) if subtract else stream_value(y)
+            assert stream_value(z, 0) == stream_value(x) + y_value
+
+
+@given(
+    lists(digits, min_size=1, max_size=8),
+    integers(min_value=-1000, max_value=1000),
+    sampled_from([0, 2, 5]),
+)
+def test_online_mul_const(xs, coeff, places):
+    assume(coeff != 0)
+    csd = to_csd(coeff / 8, places)
+    assume(csd.strip("0.") != "")
+    mul = OnlineConstantMultiplier(csd)
+    constant = stream_value(csd.replace(".", ""), len(csd.split(".")[0]) - 1)
+    out = simulate(mul, xs)
+    for x, z in zip(xs, out):
+        assert stream_value(z, mul.top) == constant * stream_value(x)
+    # the operator resets on flush
+    assert simulate(mul, xs) == out
+
+
+def test_batch_matches_single():
+    xs = ["+0-0+", "--0+", "0", "+++++"]
+    ys = ["-0+", "+-+-+", "+", "0-"]
+    batch = simulate(OnlineAdder(), xs, ys)
+    for x, y, z in zip(xs, ys, batch):
+        # the batch extends every stream with zeros to the longest one
+        assert simulate(OnlineAdder(), [x.ljust(5, "0")], [y.ljust(5, "0")]) == [z]
+
+
+def test_pack_roundtrip():
+    streams = ["+0-0+", "--0+0", "00000"]
+    assert unpack_streams(pack_streams(streams), 3) == streams
+
+
+def test_latency():
+    xs = ["+" * 16] * 4
+    assert measure(OnlineAdder(), xs, xs, repeat=1)[0] == OnlineAdder.delay
+    for csd in ("+", "+0-", "+0-.+", "-0+0+0-.0+0-", "0.000+0-"):
+        mul = OnlineConstantMultiplier(csd)
+        latency, rate = measure(mul, xs, repeat=1)
+        assert latency == mul.delay
+        assert rate > 0
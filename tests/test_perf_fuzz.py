@@ -0,0 +1,46 @@
+import pytest
+
+from csdigit.perf_fuzz import (
+    TARGETS,
+    Case,
+    evolve,
+    hypothesis_search,
+    load_corpus,
+    measure,
+    save_corpus,
+)
+
+
+@pytest.mark.parametrize("name", sorted(TARGETS))
+def test_evolve(name):
+    cases = evolve(name, generations=3, population=4, seed=1)
+    assert len(cases) == 4
+    assert all(c.name == name and c.cost > 0.0 for c in cases)
+    assert [c.cost for c in cases] == sorted((c.cost for c in cases), reverse=True)
+    for c in cases:
+        TARGETS[name][0](*c.args)  # every mutant is a valid input
+
+
+def test_measure_memory():
+    assert measure("longest_repeated_substring", ("+-0" * 20,), "memory") > 0.0
+    with pytest.raises(ValueError):
+        measure("to_csd", (1.5, 2), "cycles")
+
+
+def test_hypothesis_search():
+    cases = hypothesis_search("to_csdfixed", max_examples=10)
+    assert cases and cases[0].cost >= cases[-1].cost
+
+
+def test_corpus_round_trip(tmp_path):
+    cases = [
+        Case("to_csd", (0.1, 300), 3.0),
+        Case("to_csd", (0.1, 300), 2.0),  # the same input measured again
+        Case("to_csd", (1.5, 200), 1.0),
+        Case("to_csd", (2.5, 100), 0.5),
+        Case("to_decimal", ("+0-.0+",), 4.0),
+    ]
+    path = str(tmp_path / "corpus.json")
+    save_corpus(path, cases, 2)
+    loaded = load_corpus(path)
+    assert loaded == [cases[0], cases[2], cases[4]]
@@ -0,0 +1,91 @@
+import pytest
+from hypothesis import given
+from hypothesis.strategies import floats, integers, lists
+
+from csdigit.csd import to_csd
+from csdigit.polyphase import (
+    Decimator,
+    Interpolator,
+    decompose,
+    plan_polyphase,
+    quantize_phases,
+    recompose,
+)
+
+taps = lists(floats(-1.0, 1.0), min_size=1, max_size=24)
+samples = lists(integers(-(2**15), 2**15), max_size=40)
+blocks = lists(samples, max_size=5)
+
+
+def prototype(plan):
+    return recompose(plan.phases)
+
+
+def decimate(h, xs, factor):
+    return [
+        sum(c * xs[n - k] for k, c in enumerate(h) if 0 <= n - k)
+        for n in range(0, len(xs), factor)
+    ]
+
+
+def interpolate(h, xs, factor):
+    up = [0] * (len(xs) * factor)
+    up[::factor] = xs
+    return [
+        sum(c * up[n - k] for k, c in enumerate(h) if 0 <= n - k)
+        for n in range(len(up))
+    ]
+
+
+@given(taps, integers(1, 5))
+def test_quantize_phases(coeffs, factor):
+    phases = quantize_phases(coeffs, factor, 8)
+    assert recompose(phases) == [to_csd(c, 8) for c in coeffs]
+    assert decompose(recompose(phases), factor) == phases
+
+
+@given(taps, integers(1, 5))
+def test_plan_polyphase(coeffs, factor):
+    plan = plan_polyphase(coeffs, factor, 8)
+    assert plan.adders <= plan.separate_adders
+    assert {abs(c) for c in prototype(plan)} - {0} == set(plan.constants)
+
+
+@given(taps, integers(1, 5), blocks)
+def test_decimator(coeffs, factor, chunks):
+    plan = plan_polyphase(coeffs, factor, 8)
+    dec = Decimator(plan)
+    outputs = [y for chunk in chunks for y in dec.process(chunk)]
+    xs = [x for chunk in chunks for x in chunk]
+    assert outputs == decimate(prototype(plan), xs, factor)
+
+
+@given(taps, integers(1, 5), blocks)
+def test_interpolator(coeffs, factor, chunks):
+    plan = plan_polyphase(coeffs, factor, 8)
+    interp = Interpolator(plan)
+    outputs = [y for chunk in chunks for y in interp.process(chunk)]
+    xs = [x for chunk in chunks for x in chunk]
+    assert outputs == interpolate(prototype(plan), xs, factor)
+    interp.reset()
+    assert interp.process(xs[:3]) == interpolate(prototype(plan), xs[:3], factor)
+
+
+@given(taps, integers(1, 5), lists(integers(-31, 31), max_size=20))
+def test_narrow_lanes(coeffs, factor, xs):
+    plan = plan_polyphase(coeffs, factor, 3)
+    for kind in (Decimator, Interpolator):
+        wide, narrow = kind(plan), kind(plan, nbytes=1)
+        try:
+            outputs = narrow.process(xs)
+        except OverflowError:
+            continue
+        assert outputs == wide.process(xs)
+
+
+def test_lane_overflow():
+    plan = plan_polyphase([0.875, 0.875], 1, 3)
+    assert Interpolator(plan, nbytes=1).process([9, 0, 0]) == [63, 63, 0]
+    for kind in (Decimator, Interpolator):
+        with pytest.raises(OverflowError):
+            kind(plan, nbytes=1).process([100, 0, 0])
@@ -0,0 +1,55 @@
+from math import sin
+
+from hypothesis import given
+from hypothesis.strategies import floats, integers, lists
+
+from csdigit.csd import to_csd, to_decimal
+from csdigit.quantize import (
+    scale_search,
+    spectral_error,
+    to_csd_shaped,
+    to_csd_shaped_batch,
+)
+from csdigit.sparse import to_sparse_i
+
+
+def _lowpass(n=21, wc=0.3):
+    mid = n // 2
+    return [sin(wc * (k - mid)) / (k - mid) if k != mid else wc for k in range(n)]
+
+
+def test_to_csd_shaped_no_feedback():
+    h = _lowpass()
+    csds, values = to_csd_shaped(h, places=6, feedback=())
+    assert csds == [to_csd(c, 6) for c in h]
+    assert values == [to_decimal(c) for c in csds]
+
+
+def test_to_csd_shaped_error():
+    h = _lowpass()
+    # first-order shaping: the errors telescope, so the DC error is the last one
+    _, values = to_csd_shaped(h, places=6)
+    assert abs(sum(values) - sum(h)) <= 2**-6
+    peak, rms = spectral_error(h, values)
+    assert 0.0 < rms <= peak
+
+
+def test_to_csd_shaped_batch():
+    vecs = [_lowpass(11, 0.2), _lowpass(15, 0.4)]
+    res = to_csd_shaped_batch(vecs, nnz=3)
+    assert len(res) == 2
+    for h, (csds, values, peak, _) in zip(vecs, res):
+        assert len(csds) == len(h)
+        assert peak == spectral_error(h, values)[0]
+
+
+@given(lists(floats(-2.0, 2.0), min_size=1, max_size=16), integers(2, 12))
+def test_scale_search(coeffs, places):
+    front = scale_search(coeffs, places, 0.5, 1.0, 1 / 64)
+    assert front
+    for s, nnz, error in front:
+        qs = [round(s * c * 2**places) for c in coeffs]
+        assert nnz == sum(len(to_sparse_i(q)) for q in qs)
+        assert error == max(abs(q / (s * 2**places) - c) for q, c in zip(qs, coeffs))
+    # strictly better error for every extra digit
+    assert all(a[1] < b[1] and a[2] > b[2] for a, b in zip(front, front[1:]))
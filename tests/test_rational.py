@@ -0,0 +1,29 @@
+from fractions import Fraction
+
+from hypothesis import assume, given
+from hypothesis.strategies import integers
+
+from csdigit.csd import to_csd
+from csdigit.rational import expand_periodic, to_csd_periodic, to_fraction
+
+
+def test_to_csd_periodic():
+    assert to_csd_periodic(Fraction(1, 3)) == ("0.", "0+")
+    assert to_csd_periodic(Fraction(57, 2)) == ("+00-00.+", "")
+    assert to_csd_periodic(0) == ("0", "")
+
+
+@given(integers(), integers(min_value=1, max_value=10000))
+def test_to_fraction(numer, denom):
+    num = Fraction(numer, denom)
+    assert num == to_fraction(*to_csd_periodic(num))
+
+
+@given(integers(min_value=-1000, max_value=1000), integers(1, 200))
+def test_expand_periodic(numer, denom):
+    # multiples of 3 in the denominator hit exact ties, which the float
+    # rounding in `to_csd` may break either way
+    assume(numer != 0 and denom % 3 != 0)
+    num = Fraction(numer, denom)
+    prefix, repeat = to_csd_periodic(num)
+    assert expand_periodic(prefix, repeat, 16) == to_csd(float(num), 16)
@@ -0,0 +1,62 @@
+import pytest
+from hypothesis import given
+from hypothesis.strategies import integers, lists
+
+from csdigit.rb_adder import (
+    pack_lanes,
+    pack_values,
+    rb_add,
+    rb_neg,
+    rb_sub,
+    rb_sum,
+    rb_values,
+    to_twos_complement,
+    unpack_lanes,
+)
+
+small = integers(-(2**20), 2**20)
+
+
+@given(lists(small, min_size=1, max_size=50), lists(small, min_size=1, max_size=50))
+def test_rb_add(xs, ys):
+    count = min(len(xs), len(ys))
+    xs, ys = xs[:count], ys[:count]
+    a, b = pack_values(xs), pack_values(ys)
+    assert rb_values(a) == xs
+    assert rb_values(rb_add(a, b)) == [x + y for x, y in zip(xs, ys)]
+    assert rb_values(rb_sub(a, b)) == [x - y for x, y in zip(xs, ys)]
+    assert rb_values(rb_neg(a)) == [-x for x in xs]
+
+
+@given(lists(lists(small, min_size=4, max_size=4), min_size=1, max_size=30))
+def test_rb_sum(rows):
+    total = rb_sum([pack_values(row) for row in rows])
+    assert rb_values(total) == [sum(col) for col in zip(*rows)]
+    # the sum of non-adjacent operands need not be non-adjacent, but it is
+    # still a signed-digit number: no position holds both signs
+    assert total.pos & total.neg == 0
+
+
+def test_odd_lane_width():
+    xs = [5, -7, 1000, -1000]
+    a = pack_values(xs, 3)
+    assert rb_values(rb_add(a, a)) == [2 * x for x in xs]
+
+
+def test_overflow():
+    a = pack_values([2**13 + 2**12], 2)
+    with pytest.raises(OverflowError):
+        to_twos_complement(rb_add(rb_add(a, a), a))
+    with pytest.raises(OverflowError):
+        rb_sum([a] * 8)
+    with pytest.raises(ValueError):
+        pack_values([2**14], 2)
+
+
+@given(lists(small, max_size=50))
+def test_pack_lanes(xs):
+    x = pack_lanes(xs, 4)
+    assert x == sum(v << (32 * i) for i, v in enumerate(xs))
+    assert unpack_lanes((x << 5) - 3 * x, len(xs), 4) == [29 * v for v in xs]
+    with pytest.raises(OverflowError):
+        unpack_lanes(pack_lanes([2**15], 2) << 1, 1, 2)
@@ -0,0 +1,67 @@
+from fractions import Fraction
+
+from hypothesis import given
+from hypothesis.strategies import integers, lists, tuples
+
+from csdigit.csd import to_csd, to_csd_i
+from csdigit.sparse import (
+    csd_multiply,
+    sparse_add,
+    sparse_canonical,
+    sparse_mul,
+    sparse_neg,
+    sparse_shift,
+    sparse_to_csd,
+    sparse_value,
+    to_sparse,
+    to_sparse_f,
+    to_sparse_i,
+)
+
+
+@given(integers())
+def test_to_sparse_i(number):
+    terms = to_sparse_i(number)
+    assert sparse_value(terms) == number
+    assert sparse_to_csd(terms) == (to_csd_i(number) if number else "0")
+    assert sparse_value(sparse_neg(terms)) == -number
+    assert sparse_value(sparse_shift(terms, -3)) == Fraction(number, 8)
+
+
+@given(integers(-(2**30), 2**30), integers(0, 24), integers(0, 16))
+def test_to_sparse_f(number, shift, places):
+    fnum = number / 2**shift
+    assert to_sparse_f(fnum, places) == to_sparse(to_csd(fnum, places))
+
+
+terms = lists(tuples(integers(-20, 20), integers(-1, 1).filter(bool)), max_size=10)
+
+
+@given(terms, terms)
+def test_sparse_add(a, b):
+    a, b = sparse_canonical(a), sparse_canonical(b)
+    total = sparse_add(a, b)
+    assert sparse_value(total) == sparse_value(a) + sparse_value(b)
+    assert total == sparse_canonical(total)
+
+
+def test_sparse_big():
+    number = 3**6000
+    terms = to_sparse_i(number)
+    assert sparse_value(terms) == number
+    assert len(terms) < 6000
+
+
+@given(terms, terms)
+def test_sparse_mul(a, b):
+    product = sparse_mul(a, b)
+    assert sparse_value(product) == sparse_value(a) * sparse_value(b)
+    assert product == sparse_canonical(product)
+
+
+@given(integers(), integers(), integers(0, 40), integers(0, 40))
+def test_csd_multiply(x, y, fx, fy):
+    csd_x = sparse_to_csd(sparse_shift(to_sparse_i(x), -fx))
+    csd_y = sparse_to_csd(sparse_shift(to_sparse_i(y), -fy))
+    product = csd_multiply(csd_x, csd_y)
+    assert sparse_value(to_sparse(product)) == Fraction(x * y, 2 ** (fx + fy))
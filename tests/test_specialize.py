@@ -0,0 +1,38 @@
+import pytest
+from hypothesis import given
+from hypothesis.strategies import integers, lists
+
+from csdigit.csd import to_csd, to_csd_i, to_decimal
+from csdigit.specialize import compile_csd, compile_csd_set, interpret_csd
+
+
+@given(integers(-(2**40), 2**40), integers())
+def test_compile_csd_i(number, x):
+    csd = to_csd_i(number) if number else "0"
+    assert compile_csd(csd)(x) == number * x == interpret_csd(csd, x)
+
+
+@given(integers(-(2**20), 2**20), integers(-1000, 1000))
+def test_compile_csd(number, x):
+    csd = to_csd(number / 64, 6)
+    assert compile_csd(csd)(float(x)) == to_decimal(csd) * x
+
+
+@given(lists(integers(-5000, 5000), min_size=1, max_size=6), integers())
+def test_compile_csd_set(numbers, x):
+    csds = tuple(to_csd_i(n) if n else "0" for n in numbers)
+    assert compile_csd_set(csds)(x) == tuple(n * x for n in numbers)
+
+
+def test_compile_csd_cached():
+    assert compile_csd("+0-0+") is compile_csd("+0-0+")
+
+
+def test_invalid_digits():
+    for csd in ("+0x", "+0.-.+", " +0"):
+        with pytest.raises(ValueError):
+            compile_csd(csd)
+        with pytest.raises(ValueError):
+            compile_csd_set(("+0-", csd))
+    with pytest.raises(ValueError):
+        interpret_csd("+0x", 3)
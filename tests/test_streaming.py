@@ -0,0 +1,47 @@
+from hypothesis import given
+from hypothesis.strategies import binary, integers
+
+from csdigit.csd import to_csd_i, to_decimal_i
+from csdigit.streaming import (
+    MsbFirstRecoder,
+    recode_bytes,
+    recode_msb_first,
+    to_csd_msb,
+)
+
+
+def nnz(csd: str) -> int:
+    return csd.count("+") + csd.count("-")
+
+
+def test_to_csd_msb_exhaustive():
+    for num in range(1, 1 << 12):
+        csd = to_csd_msb(num)
+        assert to_decimal_i(csd) == num
+        assert nnz(csd) == nnz(to_csd_i(num))
+
+
+@given(integers(min_value=1, max_value=2**200))
+def test_to_csd_msb_minimal(num):
+    csd = to_csd_msb(num)
+    assert to_decimal_i(csd) == num
+    assert nnz(csd) == nnz(to_csd_i(num))
+
+
+@given(binary(max_size=32))
+def test_recode_bytes(data):
+    digits = "".join(recode_bytes([data[:3], data[3:]]))
+    assert len(digits) == 8 * len(data) + 1
+    assert to_decimal_i(digits) == int.from_bytes(data, "big")
+
+
+def test_latency():
+    rec = MsbFirstRecoder()
+    bits = [int(b) for b in format(0xB7A5, "b")]
+    out = [rec.push(b) for b in bits]
+    # one digit per bit once the lookahead is full
+    assert out[: rec.delay - 1] == [""] * (rec.delay - 1)
+    assert all(len(d) == 1 for d in out[rec.delay - 1 :])
+    tail = rec.flush()
+    assert len(tail) == rec.delay
+    assert "".join(out) + tail == "".join(recode_msb_first(bits))
@@ -0,0 +1,53 @@
+from hypothesis import given
+from hypothesis.strategies import booleans, floats, lists
+
+from csdigit.csd import to_csd, to_csdfixed, to_decimal
+from csdigit.cse import evaluate_cse
+from csdigit.symmetry import (
+    cse_symmetric,
+    symmetric_cost,
+    symmetry,
+    to_csd_symmetric,
+    to_csd_symmetric_batch,
+    to_csdfixed_symmetric,
+)
+
+taps = lists(floats(-2.0, 2.0), min_size=1, max_size=12)
+
+
+def linear_phase(half, odd, anti):
+    center = [0.0 if anti else half[-1]] if odd else []
+    body = half[:-1] if odd else half
+    mirrored = [-c if anti else c for c in reversed(body)]
+    return body + center + mirrored
+
+
+@given(taps, booleans(), booleans())
+def test_to_csd_symmetric(half, odd, anti):
+    coeffs = linear_phase(half, odd, anti)
+    assert symmetry(coeffs) in ((-1, 1) if anti else (1,))
+    assert to_csd_symmetric(coeffs, 8) == [to_csd(c, 8) for c in coeffs]
+    assert to_csdfixed_symmetric(coeffs, 3) == [to_csdfixed(c, 3) for c in coeffs]
+
+
+@given(taps)
+def test_unstructured(coeffs):
+    assert to_csd_symmetric_batch([coeffs], 6) == [[to_csd(c, 6) for c in coeffs]]
+
+
+@given(taps, booleans(), booleans())
+def test_symmetric_cost(half, odd, anti):
+    coeffs = linear_phase(half, odd, anti)
+    cost = symmetric_cost(coeffs, 8)
+    csds = [to_csd(c, 8) for c in coeffs]
+    assert cost.nnz == sum(s.count("+") + s.count("-") for s in csds)
+    assert cost.pre_adders == (len(coeffs) // 2 if cost.symmetry else 0)
+
+
+@given(taps, booleans(), booleans())
+def test_cse_symmetric(half, odd, anti):
+    coeffs = linear_phase(half, odd, anti)
+    subexprs, terms, adders = cse_symmetric(coeffs, 8)
+    expected = [round(to_decimal(to_csd(c, 8)) * 256) for c in coeffs]
+    assert evaluate_cse(subexprs, terms, 3) == [3 * c for c in expected]
+    assert adders >= len(subexprs)